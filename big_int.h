@@ -0,0 +1,982 @@
+/*
+🔢 UNIFIED BIG INTEGER CORE 🔢
+One arbitrary-precision unsigned integer for every engine, replacing the
+per-engine OptimalBigInt / BigInteger / UltraBigInt / BigInt copies.
+
+- 64-bit binary limbs with small-buffer storage (BigInt keeps 4 limbs inline)
+- Multiplication picks its own tier by operand size:
+    schoolbook < 32 limbs <= Karatsuba < 3072 limbs <= complex FFT
+    (balanced 16-bit pieces, planned by FFTPlanner) <= 2^20 points < NTT
+    (exact, over the Goldilocks prime 2^64 - 2^32 + 1)
+  An FFT product whose round-off looks unsafe is redone by the NTT.
+- Reduction by 2^p - 1 is shift-and-add; other moduli use Knuth division.
+- Expression templates fuse the Lucas-Lehmer step: s = (s * s - 2) % M is
+  evaluated in per-thread scratch with no temporaries, and squares when both
+  factors are the same object. Expressions reference their operands - never
+  hold one in `auto`.
+
+The raw limb routines in bigint::detail are shared by the Montgomery and GCD
+code built on top of this type.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fft_plan.h"
+
+namespace bigint {
+
+using limb_t = uint64_t;
+using dlimb_t = unsigned __int128;
+
+constexpr size_t KARATSUBA_THRESHOLD = 32;     // Limbs in the smaller factor
+constexpr size_t TRANSFORM_THRESHOLD = 3072;   // Limbs in the smaller factor (measured crossover)
+constexpr size_t FFT_MAX_POINTS = 1u << 20;    // Balanced 16-bit pieces stay exact in doubles
+constexpr double FFT_MAX_ROUNDOFF = 0.25;
+
+namespace detail {
+
+// ========================================
+// PER-THREAD SCRATCH
+// ========================================
+
+// Bump allocator for intermediate limbs. Blocks are kept between calls, so a
+// steady-state loop (one LL iteration after another) never touches the heap.
+class Scratch {
+private:
+    struct Block {
+        std::unique_ptr<limb_t[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t used = 0;
+
+public:
+    static Scratch& local() {
+        thread_local Scratch scratch;
+        return scratch;
+    }
+
+    limb_t* take(size_t n) {
+        while (current < blocks.size()) {
+            if (used + n <= blocks[current].size) {
+                limb_t* p = blocks[current].data.get() + used;
+                used += n;
+                return p;
+            }
+            current++;
+            used = 0;
+        }
+        size_t size = std::max<size_t>(n, blocks.empty() ? 4096 : blocks.back().size * 2);
+        blocks.push_back({std::unique_ptr<limb_t[]>(new limb_t[size]), size});
+        current = blocks.size() - 1;
+        used = n;
+        return blocks.back().data.get();
+    }
+
+    // Releases everything taken since construction when it goes out of scope
+    class Frame {
+    private:
+        Scratch& scratch;
+        size_t saved_current;
+        size_t saved_used;
+
+    public:
+        Frame() : scratch(local()), saved_current(scratch.current), saved_used(scratch.used) {}
+        ~Frame() {
+            scratch.current = saved_current;
+            scratch.used = saved_used;
+        }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        limb_t* take(size_t n) { return scratch.take(n); }
+    };
+};
+
+// ========================================
+// LIMB PRIMITIVES
+// ========================================
+
+inline size_t normalized(const limb_t* a, size_t n) {
+    while (n && a[n - 1] == 0) n--;
+    return n;
+}
+
+inline int compare(const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    if (an != bn) return an < bn ? -1 : 1;
+    for (size_t i = an; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+inline limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t s = (dlimb_t)a[i] + b[i] + carry;
+        r[i] = (limb_t)s;
+        carry = (limb_t)(s >> 64);
+    }
+    return carry;
+}
+
+inline limb_t add_1(limb_t* r, const limb_t* a, size_t n, limb_t k) {
+    for (size_t i = 0; i < n; i++) {
+        limb_t s = a[i] + k;
+        k = s < k;
+        r[i] = s;
+    }
+    return k;
+}
+
+// r = a + b for an >= bn; returns the carry out of limb an - 1
+inline limb_t add(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    limb_t carry = add_n(r, a, b, bn);
+    return add_1(r + bn, a + bn, an - bn, carry);
+}
+
+inline limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+    limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t ai = a[i], bi = b[i];
+        limb_t d = ai - bi - borrow;
+        borrow = (ai < bi) || (ai - bi < borrow);
+        r[i] = d;
+    }
+    return borrow;
+}
+
+inline limb_t sub_1(limb_t* r, const limb_t* a, size_t n, limb_t k) {
+    for (size_t i = 0; i < n; i++) {
+        limb_t ai = a[i];
+        r[i] = ai - k;
+        k = ai < k;
+    }
+    return k;
+}
+
+// r = a - b for an >= bn; returns the borrow out of limb an - 1
+inline limb_t sub(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    limb_t borrow = sub_n(r, a, b, bn);
+    return sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+// r[0, n) = a * b; returns the high limb
+inline limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * b + carry;
+        r[i] = (limb_t)p;
+        carry = (limb_t)(p >> 64);
+    }
+    return carry;
+}
+
+// r[0, n) += a * b; returns the carry limb
+inline limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * b + r[i] + carry;
+        r[i] = (limb_t)p;
+        carry = (limb_t)(p >> 64);
+    }
+    return carry;
+}
+
+// r[0, n) -= a * b; returns the borrow limb
+inline limb_t submul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * b + carry;
+        limb_t lo = (limb_t)p;
+        carry = (limb_t)(p >> 64);
+        limb_t ri = r[i];
+        r[i] = ri - lo;
+        carry += ri < lo;
+    }
+    return carry;
+}
+
+// r = a << s for 0 <= s < 64 (r == a allowed); returns the bits shifted out
+inline limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned s) {
+    if (n == 0) return 0;
+    if (s == 0) {
+        std::memmove(r, a, n * sizeof(limb_t));
+        return 0;
+    }
+    limb_t out = a[n - 1] >> (64 - s);
+    for (size_t i = n - 1; i > 0; i--) r[i] = (a[i] << s) | (a[i - 1] >> (64 - s));
+    r[0] = a[0] << s;
+    return out;
+}
+
+// r = a >> s for 0 <= s < 64 (r == a allowed)
+inline void rshift(limb_t* r, const limb_t* a, size_t n, unsigned s) {
+    if (n == 0) return;
+    if (s == 0) {
+        std::memmove(r, a, n * sizeof(limb_t));
+        return;
+    }
+    for (size_t i = 0; i + 1 < n; i++) r[i] = (a[i] >> s) | (a[i + 1] << (64 - s));
+    r[n - 1] = a[n - 1] >> s;
+}
+
+// q = a / d (q may be null or == a); returns a % d
+inline limb_t divrem_1(limb_t* q, const limb_t* a, size_t n, limb_t d) {
+    dlimb_t rem = 0;
+    for (size_t i = n; i-- > 0;) {
+        dlimb_t cur = (rem << 64) | a[i];
+        if (q) q[i] = (limb_t)(cur / d);
+        rem = cur % d;
+    }
+    return (limb_t)rem;
+}
+
+// ========================================
+// MULTIPLICATION TIERS
+// ========================================
+
+inline void mul_basecase(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    r[an] = mul_1(r, a, an, b[0]);
+    for (size_t j = 1; j < bn; j++) r[an + j] = addmul_1(r + j, a, an, b[j]);
+}
+
+// Cross products once, doubled, plus the diagonal
+inline void sqr_basecase(limb_t* r, const limb_t* a, size_t n) {
+    std::fill(r, r + 2 * n, 0);
+    for (size_t i = 0; i + 1 < n; i++) r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    lshift(r, r, 2 * n, 1);
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t sq = (dlimb_t)a[i] * a[i];
+        dlimb_t lo = (dlimb_t)r[2 * i] + (limb_t)sq + carry;
+        r[2 * i] = (limb_t)lo;
+        dlimb_t hi = (dlimb_t)r[2 * i + 1] + (limb_t)(sq >> 64) + (limb_t)(lo >> 64);
+        r[2 * i + 1] = (limb_t)hi;
+        carry = (limb_t)(hi >> 64);
+    }
+}
+
+// Balanced n x n product into r[0, 2n); a == b squares
+inline void karatsuba(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+    bool square = a == b;
+    if (n < KARATSUBA_THRESHOLD) {
+        if (square) sqr_basecase(r, a, n);
+        else mul_basecase(r, a, n, b, n);
+        return;
+    }
+
+    size_t lo = n / 2, hi = n - lo;
+    Scratch::Frame frame;
+
+    // z0 = a0*b0 -> r[0, 2lo), z2 = a1*b1 -> r[2lo, 2n)
+    karatsuba(r, a, square ? a : b, lo);
+    karatsuba(r + 2 * lo, a + lo, square ? a + lo : b + lo, hi);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    limb_t* sa = frame.take(hi + 1);
+    sa[hi] = add(sa, a + lo, hi, a, lo);
+    limb_t* sb = sa;
+    if (!square) {
+        sb = frame.take(hi + 1);
+        sb[hi] = add(sb, b + lo, hi, b, lo);
+    }
+    size_t zn = 2 * (hi + 1);
+    limb_t* z1 = frame.take(zn);
+    karatsuba(z1, sa, sb, hi + 1);
+    sub(z1, z1, zn, r, 2 * lo);
+    sub(z1, z1, zn, r + 2 * lo, 2 * hi);
+
+    // r += z1 << (64 * lo); z1 < 2^(64 * (n + hi)) so its top limbs are zero
+    size_t room = 2 * n - lo;
+    add(r + lo, r + lo, room, z1, std::min(zn, room));
+}
+
+// Split a into balanced 16-bit pieces (-2^15 <= piece < 2^15) in `out`
+template <typename Store>
+inline void balanced_pieces(const limb_t* a, size_t n, size_t points, Store store) {
+    int carry = 0;
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0; j < 4; j++, k++) {
+            int piece = (int)((a[i] >> (16 * j)) & 0xFFFF) + carry;
+            carry = piece >= 0x8000;
+            store(k, (double)(piece - (carry << 16)));
+        }
+    }
+    store(k++, (double)carry);
+    for (; k < points; k++) store(k, 0.0);
+}
+
+// Complex FFT product; false if round-off was too high to trust the result
+inline bool fft_mul(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    bool square = a == b && an == bn;
+    size_t points = 1;
+    while (points < 4 * (an + bn) + 2) points <<= 1;
+
+    thread_local std::vector<std::complex<double>> z;
+    z.resize(points);
+
+    // Real part carries a, imaginary part carries b: one forward transform for both
+    balanced_pieces(a, an, points, [&](size_t k, double v) { z[k] = {v, 0.0}; });
+    if (!square) balanced_pieces(b, bn, points, [&](size_t k, double v) { z[k].imag(v); });
+
+    FFTPlanner& planner = FFTPlanner::instance();
+    FFTPlan plan = planner.plan_for(points);
+    planner.execute(plan, z.data(), points, false);
+
+    if (square) {
+        for (size_t k = 0; k < points; k++) z[k] *= z[k];
+    } else {
+        // A_k B_k = (Z_k^2 - conj(Z_{-k})^2) / 4i
+        for (size_t k = 0; k <= points / 2; k++) {
+            size_t j = (points - k) & (points - 1);
+            std::complex<double> zk = z[k], zj = z[j];
+            std::complex<double> ck = zk * zk - std::conj(zj) * std::conj(zj);
+            std::complex<double> cj = zj * zj - std::conj(zk) * std::conj(zk);
+            z[k] = {ck.imag() * 0.25, -ck.real() * 0.25};
+            z[j] = {cj.imag() * 0.25, -cj.real() * 0.25};
+        }
+    }
+    planner.execute(plan, z.data(), points, true);
+
+    // Round, check, and carry the signed coefficients back into 64-bit limbs
+    size_t rn = an + bn;
+    double max_roundoff = 0;
+    __int128 carry = 0;
+    size_t k = 0;
+    for (size_t i = 0; i < rn; i++) {
+        limb_t limb = 0;
+        for (int j = 0; j < 4; j++, k++) {
+            double v = z[k].real();
+            double rounded = std::nearbyint(v);
+            max_roundoff = std::max(max_roundoff, std::fabs(v - rounded));
+            carry += (__int128)(int64_t)rounded;
+            limb |= (limb_t)((uint64_t)carry & 0xFFFF) << (16 * j);
+            carry >>= 16;
+        }
+        r[i] = limb;
+    }
+    return max_roundoff <= FFT_MAX_ROUNDOFF;
+}
+
+// Arithmetic mod the Goldilocks prime P = 2^64 - 2^32 + 1 (2^32-th roots of unity exist)
+namespace goldilocks {
+
+constexpr uint64_t P = 0xFFFFFFFF00000001ULL;
+constexpr uint64_t EPSILON = 0xFFFFFFFFULL;   // 2^64 mod P
+constexpr uint64_t GENERATOR = 7;
+
+inline uint64_t reduce(dlimb_t x) {
+    uint64_t lo = (uint64_t)x, hi = (uint64_t)(x >> 64);
+    uint64_t hi_hi = hi >> 32, hi_lo = hi & EPSILON;
+    // x = lo + hi_lo * 2^64 + hi_hi * 2^96, with 2^64 = 2^32 - 1 and 2^96 = -1
+    uint64_t t = lo - hi_hi;
+    if (lo < hi_hi) t -= EPSILON;
+    uint64_t u = hi_lo * EPSILON;
+    uint64_t s = t + u;
+    if (s < u) s += EPSILON;
+    return s >= P ? s - P : s;
+}
+
+inline uint64_t mul(uint64_t a, uint64_t b) { return reduce((dlimb_t)a * b); }
+
+inline uint64_t add(uint64_t a, uint64_t b) {
+    uint64_t s = a + b;
+    return (s < a || s >= P) ? s - P : s;
+}
+
+inline uint64_t sub(uint64_t a, uint64_t b) { return a >= b ? a - b : a - b + P; }
+
+inline uint64_t pow(uint64_t a, uint64_t e) {
+    uint64_t r = 1;
+    for (; e; e >>= 1, a = mul(a, a)) {
+        if (e & 1) r = mul(r, a);
+    }
+    return r;
+}
+
+// In-place cyclic NTT of power-of-two length n; invert includes the 1/n.
+// threads > 1 splits each pass's butterflies over the current FFTThreadPool.
+inline void ntt(uint64_t* a, size_t n, bool invert, int threads = 1) {
+    thread_local std::vector<uint64_t> roots;   // w_n^k for k < n/2
+    thread_local size_t roots_n = 0;
+    if (roots_n != n) {
+        roots.resize(n / 2);
+        uint64_t w = pow(GENERATOR, (P - 1) / n), x = 1;
+        for (size_t k = 0; k < n / 2; k++, x = mul(x, w)) roots[k] = x;
+        roots_n = n;
+    }
+
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(a[i], a[j]);
+    }
+    const uint64_t* w = roots.data();
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2, stride = n / len;
+        if (threads > 1) {
+            // Butterfly t: group t / half, offset t % half
+            int shift = 0;
+            while (((size_t)1 << shift) < half) shift++;
+            FFTThreadPool::parallel_for(threads, n / 2, [=](size_t lo, size_t hi) {
+                for (size_t t = lo; t < hi; t++) {
+                    size_t j = t & (half - 1), i = ((t >> shift) << (shift + 1)) + j;
+                    uint64_t u = a[i], v = mul(a[i + half], w[j * stride]);
+                    a[i] = add(u, v);
+                    a[i + half] = sub(u, v);
+                }
+            });
+            continue;
+        }
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; j++) {
+                uint64_t u = a[i + j], v = mul(a[i + j + half], w[j * stride]);
+                a[i + j] = add(u, v);
+                a[i + j + half] = sub(u, v);
+            }
+        }
+    }
+
+    // Inverse = forward transform, index-reversed, scaled
+    if (invert) {
+        std::reverse(a + 1, a + n);
+        uint64_t inv_n = pow(n, P - 2);
+        for (size_t i = 0; i < n; i++) a[i] = mul(a[i], inv_n);
+    }
+}
+
+} // namespace goldilocks
+
+// Exact NTT product on 16-bit pieces (n * 2^32 < P for every n up to 2^32)
+inline void ntt_mul(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn, int threads = 1) {
+    bool square = a == b && an == bn;
+    size_t points = 1;
+    while (points < 4 * (an + bn)) points <<= 1;
+
+    thread_local std::vector<uint64_t> fa, fb;
+    auto load = [points](std::vector<uint64_t>& f, const limb_t* x, size_t xn) {
+        f.assign(points, 0);
+        for (size_t i = 0; i < xn; i++) {
+            for (int j = 0; j < 4; j++) f[4 * i + j] = (x[i] >> (16 * j)) & 0xFFFF;
+        }
+    };
+
+    load(fa, a, an);
+    goldilocks::ntt(fa.data(), points, false, threads);
+    if (square) {
+        for (size_t k = 0; k < points; k++) fa[k] = goldilocks::mul(fa[k], fa[k]);
+    } else {
+        load(fb, b, bn);
+        goldilocks::ntt(fb.data(), points, false, threads);
+        for (size_t k = 0; k < points; k++) fa[k] = goldilocks::mul(fa[k], fb[k]);
+    }
+    goldilocks::ntt(fa.data(), points, true, threads);
+
+    dlimb_t carry = 0;
+    for (size_t i = 0; i < an + bn; i++) {
+        limb_t limb = 0;
+        for (int j = 0; j < 4; j++) {
+            carry += fa[4 * i + j];
+            limb |= (limb_t)(carry & 0xFFFF) << (16 * j);
+            carry >>= 16;
+        }
+        r[i] = limb;
+    }
+}
+
+// r[0, an + bn) = a * b. r must not overlap a or b; a == b (same length) squares.
+inline void mul(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn == 0) {
+        std::fill(r, r + an, 0);
+        return;
+    }
+    if (bn < KARATSUBA_THRESHOLD) {
+        if (a == b && an == bn) sqr_basecase(r, a, an);
+        else mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    if (bn >= TRANSFORM_THRESHOLD) {
+        size_t points = 1;
+        while (points < 4 * (an + bn) + 2) points <<= 1;
+        if (points <= FFT_MAX_POINTS && fft_mul(r, a, an, b, bn)) return;
+        ntt_mul(r, a, an, b, bn);
+        return;
+    }
+    if (an == bn) {
+        karatsuba(r, a, b, an);
+        return;
+    }
+
+    // Unbalanced: bn-limb slices of a, each a balanced product
+    Scratch::Frame frame;
+    limb_t* part = frame.take(2 * bn);
+    std::fill(r, r + an + bn, 0);
+    for (size_t offset = 0; offset < an; offset += bn) {
+        size_t len = std::min(bn, an - offset);
+        mul(part, b, bn, a + offset, len);
+        add(r + offset, r + offset, an + bn - offset, part, len + bn);
+    }
+}
+
+// ========================================
+// DIVISION AND REDUCTION
+// ========================================
+
+// Knuth algorithm D: q = a / b (an - bn + 1 limbs, may be null), r = a % b (bn limbs).
+// Requires an >= bn and b[bn - 1] != 0.
+inline void divrem(limb_t* q, limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+    if (bn == 1) {
+        r[0] = divrem_1(q, a, an, b[0]);
+        return;
+    }
+
+    Scratch::Frame frame;
+    unsigned s = __builtin_clzll(b[bn - 1]);
+    limb_t* d = frame.take(bn);
+    lshift(d, b, bn, s);
+    limb_t* u = frame.take(an + 1);
+    u[an] = lshift(u, a, an, s);
+
+    limb_t d1 = d[bn - 1], d2 = d[bn - 2];
+    for (size_t j = an - bn + 1; j-- > 0;) {
+        dlimb_t top = ((dlimb_t)u[j + bn] << 64) | u[j + bn - 1];
+        dlimb_t qhat = top / d1, rhat = top % d1;
+        while ((qhat >> 64) || qhat * d2 > ((rhat << 64) | u[j + bn - 2])) {
+            qhat--;
+            rhat += d1;
+            if (rhat >> 64) break;
+        }
+        limb_t borrow = submul_1(u + j, d, bn, (limb_t)qhat);
+        limb_t head = u[j + bn];
+        u[j + bn] = head - borrow;
+        if (head < borrow) {
+            qhat--;
+            u[j + bn] += add_n(u + j, u + j, d, bn);
+        }
+        if (q) q[j] = (limb_t)qhat;
+    }
+    rshift(r, u, bn, s);
+}
+
+// p when the value is 2^p - 1 (p >= 1), else 0
+inline size_t mersenne_exponent(const limb_t* m, size_t n) {
+    if (n == 0) return 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (m[i] != ~(limb_t)0) return 0;
+    }
+    limb_t top = m[n - 1];
+    if (top & (top + 1)) return 0;
+    return 64 * (n - 1) + (64 - __builtin_clzll(top));
+}
+
+// x mod (2^p - 1) in place by folding the bits above p back onto the bottom.
+// x needs one spare limb of room; returns the new length.
+inline size_t fold_mersenne(limb_t* x, size_t xn, size_t p) {
+    size_t word = p / 64;
+    unsigned bit = p % 64;
+    size_t mn = (p + 63) / 64;
+    Scratch::Frame frame;
+    limb_t* high = frame.take(xn + 1);
+
+    auto above_p = [&]() { return xn > mn || (xn == mn && bit && (x[word] >> bit)); };
+    while (above_p()) {
+        size_t hn = xn - word;
+        rshift(high, x + word, hn, bit);
+        hn = normalized(high, hn);
+
+        xn = std::min(xn, mn);
+        if (bit && word < xn) x[word] &= ((limb_t)1 << bit) - 1;
+        xn = normalized(x, xn);
+
+        if (xn < hn) {
+            std::fill(x + xn, x + hn, 0);
+            xn = hn;
+        }
+        x[xn] = add(x, x, xn, high, hn);
+        xn = normalized(x, xn + 1);
+    }
+
+    // 2^p - 1 itself is congruent to zero
+    if (xn == mn && mersenne_exponent(x, xn) == p) xn = 0;
+    return xn;
+}
+
+// x mod m in place (x holds at least max(xn, mn) + 1 limbs); returns the new length
+inline size_t reduce(limb_t* x, size_t xn, const limb_t* m, size_t mn) {
+    if (size_t p = mersenne_exponent(m, mn)) return fold_mersenne(x, xn, p);
+    if (compare(x, xn, m, mn) < 0) return xn;
+    Scratch::Frame frame;
+    limb_t* r = frame.take(mn);
+    divrem(nullptr, r, x, xn, m, mn);
+    std::copy(r, r + mn, x);
+    return normalized(x, mn);
+}
+
+} // namespace detail
+
+// ========================================
+// BIG INTEGER
+// ========================================
+
+template <size_t InlineLimbs>
+class BasicBigInt {
+    static_assert(InlineLimbs >= 1, "need at least one inline limb");
+
+private:
+    limb_t inline_limbs[InlineLimbs];
+    limb_t* limbs = inline_limbs;
+    size_t count = 0;                 // Normalized: limbs[count - 1] != 0
+    size_t capacity = InlineLimbs;
+
+    void release() {
+        if (limbs != inline_limbs) delete[] limbs;
+    }
+
+    // Grows storage; never shrinks, so a loop's value settles into one buffer
+    void reserve(size_t n) {
+        if (n <= capacity) return;
+        size_t grown = std::max(n, 2 * capacity);
+        limb_t* fresh = new limb_t[grown];
+        std::copy(limbs, limbs + count, fresh);
+        release();
+        limbs = fresh;
+        capacity = grown;
+    }
+
+    void assign_limbs(const limb_t* src, size_t n) {
+        n = detail::normalized(src, n);
+        reserve(n);
+        std::copy(src, src + n, limbs);
+        count = n;
+    }
+
+    // *this = (a * b - k) [% m], in scratch - the one evaluation behind every expression
+    void evaluate(const BasicBigInt& a, const BasicBigInt& b, uint64_t k, const BasicBigInt* m) {
+        if (m && m->is_zero()) throw std::domain_error("BigInt: modulus is zero");
+
+        detail::Scratch::Frame frame;
+        size_t xn = a.count + b.count;
+        size_t room = std::max(xn, m ? m->count : 0) + 1;
+        limb_t* x = frame.take(room);
+        if (a.count && b.count) {
+            detail::mul(x, a.limbs, a.count, b.limbs, b.count);
+            xn = detail::normalized(x, xn);
+        } else {
+            xn = 0;
+        }
+
+        if (!m) {
+            if (k) {
+                if (xn == 0 || (xn == 1 && x[0] < k)) throw std::underflow_error("BigInt: negative result");
+                detail::sub_1(x, x, xn, k);
+                xn = detail::normalized(x, xn);
+            }
+            assign_limbs(x, xn);
+            return;
+        }
+
+        xn = detail::reduce(x, xn, m->limbs, m->count);
+        if (m->count == 1) k %= m->limbs[0];   // A wider m already exceeds k
+        if (k) {
+            if (xn > 1 || (xn == 1 && x[0] >= k)) {
+                detail::sub_1(x, x, xn, k);
+            } else {
+                // x - k wraps: x + m - k
+                detail::add(x, m->limbs, m->count, x, xn);
+                xn = m->count;
+                detail::sub_1(x, x, xn, k);
+            }
+            xn = detail::normalized(x, xn);
+        }
+        assign_limbs(x, xn);
+    }
+
+public:
+    // ========================================
+    // EXPRESSIONS
+    // ========================================
+
+    struct Product {
+        const BasicBigInt& a;
+        const BasicBigInt& b;
+        operator BasicBigInt() const { BasicBigInt r; r.evaluate(a, b, 0, nullptr); return r; }
+    };
+
+    struct ProductMinus {
+        const BasicBigInt& a;
+        const BasicBigInt& b;
+        uint64_t k;
+        operator BasicBigInt() const { BasicBigInt r; r.evaluate(a, b, k, nullptr); return r; }
+    };
+
+    struct ReducedProduct {
+        const BasicBigInt& a;
+        const BasicBigInt& b;
+        uint64_t k;
+        const BasicBigInt& m;
+        operator BasicBigInt() const { BasicBigInt r; r.evaluate(a, b, k, &m); return r; }
+    };
+
+    // ========================================
+    // CONSTRUCTION
+    // ========================================
+
+    BasicBigInt(uint64_t value = 0) {
+        inline_limbs[0] = value;
+        count = value != 0;
+    }
+
+    explicit BasicBigInt(const std::string& decimal) {
+        for (char c : decimal) {
+            if (c < '0' || c > '9') continue;
+            reserve(count + 1);
+            limbs[count] = detail::mul_1(limbs, limbs, count, 10);
+            detail::add_1(limbs, limbs, count + 1, (limb_t)(c - '0'));
+            count = detail::normalized(limbs, count + 1);
+        }
+    }
+
+    BasicBigInt(const BasicBigInt& other) { assign_limbs(other.limbs, other.count); }
+
+    BasicBigInt(BasicBigInt&& other) noexcept {
+        if (other.limbs != other.inline_limbs) {
+            limbs = other.limbs;
+            capacity = other.capacity;
+            other.limbs = other.inline_limbs;
+            other.capacity = InlineLimbs;
+        } else {
+            std::copy(other.inline_limbs, other.inline_limbs + other.count, inline_limbs);
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    ~BasicBigInt() { release(); }
+
+    BasicBigInt& operator=(const BasicBigInt& other) {
+        if (this != &other) assign_limbs(other.limbs, other.count);
+        return *this;
+    }
+
+    // Keeps this object's buffer when it is already large enough
+    BasicBigInt& operator=(BasicBigInt&& other) noexcept {
+        if (this == &other) return *this;
+        if (other.limbs != other.inline_limbs && other.capacity > capacity) {
+            release();
+            limbs = other.limbs;
+            capacity = other.capacity;
+            count = other.count;
+            other.limbs = other.inline_limbs;
+            other.capacity = InlineLimbs;
+        } else {
+            std::copy(other.limbs, other.limbs + other.count, limbs);
+            count = other.count;
+        }
+        other.count = 0;
+        return *this;
+    }
+
+    BasicBigInt& operator=(const Product& e) { evaluate(e.a, e.b, 0, nullptr); return *this; }
+    BasicBigInt& operator=(const ProductMinus& e) { evaluate(e.a, e.b, e.k, nullptr); return *this; }
+    BasicBigInt& operator=(const ReducedProduct& e) { evaluate(e.a, e.b, e.k, &e.m); return *this; }
+
+    static BasicBigInt from_limbs(const limb_t* src, size_t n) {
+        BasicBigInt r;
+        r.assign_limbs(src, n);
+        return r;
+    }
+
+    static BasicBigInt power_of_two(size_t exponent) {
+        BasicBigInt r;
+        r.reserve(exponent / 64 + 1);
+        std::fill(r.limbs, r.limbs + exponent / 64, 0);
+        r.limbs[exponent / 64] = (limb_t)1 << (exponent % 64);
+        r.count = exponent / 64 + 1;
+        return r;
+    }
+
+    // 2^p - 1
+    static BasicBigInt mersenne(size_t p) {
+        BasicBigInt r;
+        if (p == 0) return r;
+        size_t n = (p + 63) / 64;
+        r.reserve(n);
+        std::fill(r.limbs, r.limbs + n, ~(limb_t)0);
+        if (p % 64) r.limbs[n - 1] = ((limb_t)1 << (p % 64)) - 1;
+        r.count = n;
+        return r;
+    }
+
+    // ========================================
+    // INSPECTION
+    // ========================================
+
+    size_t size() const { return count; }
+    const limb_t* data() const { return limbs; }
+    limb_t limb(size_t i) const { return i < count ? limbs[i] : 0; }
+    uint64_t low64() const { return count ? limbs[0] : 0; }
+    bool is_zero() const { return count == 0; }
+    bool is_odd() const { return count && (limbs[0] & 1); }
+
+    size_t bit_length() const {
+        return count ? 64 * (count - 1) + (64 - __builtin_clzll(limbs[count - 1])) : 0;
+    }
+
+    bool bit(size_t i) const { return (limb(i / 64) >> (i % 64)) & 1; }
+
+    // this mod 2^bits
+    BasicBigInt low_bits(size_t bits) const {
+        if (bits >= bit_length()) return *this;
+        size_t words = (bits + 63) / 64;
+        BasicBigInt r;
+        r.reserve(words);
+        std::copy(limbs, limbs + words, r.limbs);
+        if (bits % 64) r.limbs[words - 1] &= ((limb_t)1 << (bits % 64)) - 1;
+        r.count = detail::normalized(r.limbs, words);
+        return r;
+    }
+
+    // p when this is 2^p - 1, else 0
+    size_t mersenne_exponent() const { return detail::mersenne_exponent(limbs, count); }
+
+    static int compare(const BasicBigInt& a, const BasicBigInt& b) {
+        return detail::compare(a.limbs, a.count, b.limbs, b.count);
+    }
+
+    uint64_t mod_u64(uint64_t m) const {
+        if (m == 0) throw std::domain_error("BigInt: modulus is zero");
+        return detail::divrem_1(nullptr, limbs, count, m);
+    }
+
+    std::string to_string() const {
+        if (count == 0) return "0";
+        const limb_t CHUNK = 10000000000000000000ULL;   // 10^19
+        std::vector<limb_t> work(limbs, limbs + count);
+        std::vector<limb_t> chunks;
+        size_t n = count;
+        while (n) {
+            chunks.push_back(detail::divrem_1(work.data(), work.data(), n, CHUNK));
+            n = detail::normalized(work.data(), n);
+        }
+        std::string s = std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string part = std::to_string(chunks[i]);
+            s += std::string(19 - part.size(), '0') + part;
+        }
+        return s;
+    }
+
+    // ========================================
+    // ARITHMETIC
+    // ========================================
+
+    Product square() const { return {*this, *this}; }
+
+    friend Product operator*(const BasicBigInt& a, const BasicBigInt& b) { return {a, b}; }
+    friend ProductMinus operator-(const Product& e, uint64_t k) { return {e.a, e.b, k}; }
+    friend ReducedProduct operator%(const Product& e, const BasicBigInt& m) { return {e.a, e.b, 0, m}; }
+    friend ReducedProduct operator%(const ProductMinus& e, const BasicBigInt& m) { return {e.a, e.b, e.k, m}; }
+
+    friend BasicBigInt operator+(const BasicBigInt& a, const BasicBigInt& b) {
+        const BasicBigInt& big = a.count >= b.count ? a : b;
+        const BasicBigInt& small = a.count >= b.count ? b : a;
+        BasicBigInt r;
+        r.reserve(big.count + 1);
+        r.limbs[big.count] = detail::add(r.limbs, big.limbs, big.count, small.limbs, small.count);
+        r.count = detail::normalized(r.limbs, big.count + 1);
+        return r;
+    }
+
+    friend BasicBigInt operator-(const BasicBigInt& a, const BasicBigInt& b) {
+        if (compare(a, b) < 0) throw std::underflow_error("BigInt: negative result");
+        BasicBigInt r;
+        r.reserve(a.count);
+        detail::sub(r.limbs, a.limbs, a.count, b.limbs, b.count);
+        r.count = detail::normalized(r.limbs, a.count);
+        return r;
+    }
+
+    friend BasicBigInt operator/(const BasicBigInt& a, const BasicBigInt& b) {
+        if (b.is_zero()) throw std::domain_error("BigInt: division by zero");
+        if (compare(a, b) < 0) return BasicBigInt();
+        detail::Scratch::Frame frame;
+        limb_t* q = frame.take(a.count - b.count + 1);
+        limb_t* r = frame.take(b.count);
+        detail::divrem(q, r, a.limbs, a.count, b.limbs, b.count);
+        BasicBigInt quotient;
+        quotient.assign_limbs(q, a.count - b.count + 1);
+        return quotient;
+    }
+
+    friend BasicBigInt operator%(const BasicBigInt& a, const BasicBigInt& m) {
+        if (m.is_zero()) throw std::domain_error("BigInt: modulus is zero");
+        detail::Scratch::Frame frame;
+        limb_t* x = frame.take(std::max(a.count, m.count) + 1);
+        std::copy(a.limbs, a.limbs + a.count, x);
+        size_t xn = detail::reduce(x, a.count, m.limbs, m.count);
+        BasicBigInt r;
+        r.assign_limbs(x, xn);
+        return r;
+    }
+
+    friend BasicBigInt operator<<(const BasicBigInt& a, size_t bits) {
+        if (a.is_zero()) return a;
+        size_t words = bits / 64;
+        BasicBigInt r;
+        r.reserve(a.count + words + 1);
+        std::fill(r.limbs, r.limbs + words, 0);
+        r.limbs[a.count + words] = detail::lshift(r.limbs + words, a.limbs, a.count, bits % 64);
+        r.count = detail::normalized(r.limbs, a.count + words + 1);
+        return r;
+    }
+
+    friend BasicBigInt operator>>(const BasicBigInt& a, size_t bits) {
+        size_t words = bits / 64;
+        if (words >= a.count) return BasicBigInt();
+        BasicBigInt r;
+        r.reserve(a.count - words);
+        detail::rshift(r.limbs, a.limbs + words, a.count - words, bits % 64);
+        r.count = detail::normalized(r.limbs, a.count - words);
+        return r;
+    }
+
+    BasicBigInt& operator+=(const BasicBigInt& b) { return *this = *this + b; }
+    BasicBigInt& operator-=(const BasicBigInt& b) { return *this = *this - b; }
+    BasicBigInt& operator*=(const BasicBigInt& b) { evaluate(*this, b, 0, nullptr); return *this; }
+    BasicBigInt& operator/=(const BasicBigInt& b) { return *this = *this / b; }
+    BasicBigInt& operator%=(const BasicBigInt& m) { return *this = *this % m; }
+    BasicBigInt& operator<<=(size_t bits) { return *this = *this << bits; }
+    BasicBigInt& operator>>=(size_t bits) { return *this = *this >> bits; }
+
+    friend bool operator==(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) == 0; }
+    friend bool operator!=(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) != 0; }
+    friend bool operator<(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) < 0; }
+    friend bool operator<=(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) <= 0; }
+    friend bool operator>(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) > 0; }
+    friend bool operator>=(const BasicBigInt& a, const BasicBigInt& b) { return compare(a, b) >= 0; }
+
+    friend std::ostream& operator<<(std::ostream& out, const BasicBigInt& a) { return out << a.to_string(); }
+};
+
+} // namespace bigint
+
+using BigInt = bigint::BasicBigInt<4>;
@@ -0,0 +1,76 @@
+/*
+🔢 BIG INTEGER REGRESSION TEST 🔢
+Checks the fused (a * b - k) % m evaluation in big_int.h against 128-bit
+arithmetic, including the cases where k is a multiple of m.
+
+Usage: big_int_test   (exit code 0 = all checks passed)
+Build: g++ -std=c++17 -O2 -pthread big_int_test.cpp -o big_int_test
+*/
+
+#include <iostream>
+#include <random>
+#include <cstdint>
+
+#include "big_int.h"
+
+using namespace std;
+
+static int failures = 0;
+
+// (a * b - k) mod m, with a * b - k taken mod m before it can go negative
+static uint64_t reference(uint64_t a, uint64_t b, uint64_t k, uint64_t m) {
+    unsigned __int128 x = (unsigned __int128)a * b % m;
+    uint64_t kk = k % m;
+    return (uint64_t)((x + m - kk) % m);
+}
+
+static void check(uint64_t a, uint64_t b, uint64_t k, uint64_t m) {
+    BigInt A(a), B(b), M(m);
+    BigInt r = (A * B - k) % M;
+    uint64_t expected = reference(a, b, k, m);
+    if (r != BigInt(expected)) {
+        cout << "❌ (" << a << " * " << b << " - " << k << ") % " << m << " = " << r << ", expected " << expected << endl;
+        failures++;
+    }
+}
+
+int main() {
+    // A reduced product of 0 with k a multiple of m must stay 0, not become m
+    check(6, 5, 3, 3);
+    check(0, 5, 7, 7);
+    check(12345, 678, 0, 1);
+    check(12345, 678, 99, 1);
+    check(4, 4, 14, 2);
+    check(0, 0, 0, 5);
+
+    // Wraps: x < k
+    check(2, 3, 10, 7);
+    check(0, 9, 1, (uint64_t)-1);
+
+    mt19937_64 rng(20261018);
+    for (int i = 0; i < 100000; i++) {
+        uint64_t m = 1 + rng() % (i % 2 ? 1000 : UINT64_MAX);
+        uint64_t k = i % 3 == 0 ? (rng() % 8) * m : rng();
+        check(rng(), rng() % 1000, k, m);
+    }
+
+    // Multi-limb modulus: m = 2^64 + 1 exceeds every k
+    BigInt big = (BigInt(1) << 64) + BigInt(1);
+    BigInt wrapped = (BigInt(0) * BigInt(5) - 7) % big;
+    if (wrapped != big - BigInt(7)) {
+        cout << "❌ (0 * 5 - 7) % (2^64 + 1) = " << wrapped << endl;
+        failures++;
+    }
+    BigInt exact = (BigInt(0) * BigInt(5) - 0) % big;
+    if (!exact.is_zero()) {
+        cout << "❌ (0 * 5 - 0) % (2^64 + 1) = " << exact << endl;
+        failures++;
+    }
+
+    if (failures) {
+        cout << "❌ " << failures << " checks failed" << endl;
+        return 1;
+    }
+    cout << "✅ All big integer checks passed" << endl;
+    return 0;
+}
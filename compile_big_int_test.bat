@@ -0,0 +1,25 @@
+@echo off
+echo 🔢 COMPILING BIG INTEGER REGRESSION TEST 🔢
+echo Fused (a * b - k) %% m evaluation against 128-bit arithmetic
+
+where g++ >nul 2>nul
+if %errorlevel% neq 0 (
+    echo ❌ Error: g++ compiler not found
+    echo Please install MinGW-w64 or MSYS2
+    pause
+    exit /b 1
+)
+
+g++ -std=c++17 -O3 -mtune=generic ^
+    -funroll-loops -DNDEBUG -pthread ^
+    big_int_test.cpp ^
+    -o big_int_test.exe
+
+if %errorlevel% equ 0 (
+    echo ✅ Compilation successful!
+    echo 🎯 Run big_int_test.exe - exit code 0 means every check passed
+) else (
+    echo ❌ Compilation failed!
+)
+
+pause
@@ -17,7 +17,7 @@ echo 📦 Compiling complete system with maximum optimization...
 
 if %USE_GMP%==1 (
     echo ✅ Using GMP for Prime95-equivalent performance
-    g++ -std=c++17 -O3 -march=native -mtune=native -flto ^
+    g++ -std=c++17 -O3 -mtune=generic -flto ^
         -funroll-loops -ffast-math -DNDEBUG -DUSE_GMP ^
         -pthread -fopenmp ^
         -I"%GMP_PATH%\include" -L"%GMP_PATH%\lib" ^
@@ -26,7 +26,7 @@ if %USE_GMP%==1 (
         -o mersenne_system.exe
 ) else (
     echo ⚠️ GMP not found - using optimized fallback
-    g++ -std=c++17 -O3 -march=native -mtune=native -flto ^
+    g++ -std=c++17 -O3 -mtune=generic -flto ^
         -funroll-loops -ffast-math -DNDEBUG ^
         -pthread -fopenmp ^
         complete_cpp_mersenne_system.cpp ^
@@ -0,0 +1,27 @@
+@echo off
+echo 🧭 COMPILING FFT TUNER 🧭
+echo Times FFT plan variants on this host and writes fft_wisdom.txt
+
+where g++ >nul 2>nul
+if %errorlevel% neq 0 (
+    echo ❌ Error: g++ compiler not found
+    echo Please install MinGW-w64 or MSYS2
+    pause
+    exit /b 1
+)
+
+g++ -std=c++17 -O3 -mtune=generic ^
+    -funroll-loops -DNDEBUG -pthread ^
+    fft_tuner.cpp ^
+    -o fft_tuner.exe
+
+if %errorlevel% equ 0 (
+    echo ✅ Compilation successful!
+    echo 🚀 Tuning FFT plans for this CPU...
+    fft_tuner.exe
+    echo 🎯 Engines load fft_wisdom.txt automatically at startup
+) else (
+    echo ❌ Compilation failed!
+)
+
+pause
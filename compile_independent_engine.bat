@@ -13,10 +13,9 @@ if %errorlevel% neq 0 (
 echo 📦 Compiling independent engine with maximum optimizations...
 
 REM Compile with all optimizations
-g++ -std=c++17 -O3 -march=native -mtune=native -flto ^
+g++ -std=c++17 -O3 -mtune=generic -flto ^
     -funroll-loops -ffast-math -DNDEBUG ^
     -fopenmp -pthread ^
-    -mavx2 -mfma ^
     independent_mersenne_engine.cpp ^
     -o independent_mersenne_engine.exe
 
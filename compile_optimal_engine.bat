@@ -30,10 +30,9 @@ echo 📦 Compiling with maximum optimizations...
 
 if %USE_GMP%==1 (
     echo 🚀 Using GMP for GIMPS-level performance
-    g++ -std=c++17 -O3 -march=native -mtune=native -flto ^
+    g++ -std=c++17 -O3 -mtune=generic -flto ^
         -funroll-loops -ffast-math -DNDEBUG -DUSE_GMP ^
         -fopenmp -pthread ^
-        -mavx2 -mfma -msse4.2 ^
         -I"%GMP_PATH%\include" ^
         -L"%GMP_PATH%\lib" ^
         optimal_mersenne_engine.cpp ^
@@ -41,10 +40,9 @@ if %USE_GMP%==1 (
         -o optimal_mersenne_engine.exe
 ) else (
     echo 🔧 Using optimized fallback implementation
-    g++ -std=c++17 -O3 -march=native -mtune=native -flto ^
+    g++ -std=c++17 -O3 -mtune=generic -flto ^
         -funroll-loops -ffast-math -DNDEBUG ^
         -fopenmp -pthread ^
-        -mavx2 -mfma -msse4.2 ^
         optimal_mersenne_engine.cpp ^
         -o optimal_mersenne_engine.exe
 )
@@ -0,0 +1,26 @@
+@echo off
+echo 💾 COMPILING OUT-OF-CORE MERSENNE TEST 💾
+echo Lucas-Lehmer / PRP with the residue streamed from disk
+
+where g++ >nul 2>nul
+if %errorlevel% neq 0 (
+    echo ❌ Error: g++ compiler not found
+    echo Please install MinGW-w64 or MSYS2
+    pause
+    exit /b 1
+)
+
+g++ -std=c++17 -O3 -mtune=generic ^
+    -funroll-loops -DNDEBUG -pthread ^
+    out_of_core_test.cpp ^
+    -o out_of_core_test.exe
+
+if %errorlevel% equ 0 (
+    echo ✅ Compilation successful!
+    echo 🎯 Usage: out_of_core_test.exe ^<exponent^> [ll^|prp] [memory_limit_gb]
+    echo 📦 Default memory limit: memory_limit_gb in mersenne_search_config.json
+) else (
+    echo ❌ Compilation failed!
+)
+
+pause
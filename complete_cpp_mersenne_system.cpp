@@ -18,6 +18,20 @@ Same time complexity as Prime95 with GMP integration
 #include <cmath>
 #include <random>
 #include <cstdlib>
+#include <functional>
+#include <charconv>
+#include <condition_variable>
+#include <ctime>
+#include <string_view>
+
+#include "trace_recorder.h"
+#include "sampling_profiler.h"
+#include "shared_tables.h"
+#include "concurrency_controller.h"
+#include "result_statistics.h"
+#include "confirmation_pipeline.h"
+#include "http_arena.h"
+#include "json_string.h"
 
 #ifdef USE_GMP
 #include <gmp.h>
@@ -29,11 +43,17 @@ Same time complexity as Prime95 with GMP integration
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #pragma comment(lib, "ws2_32.lib")
 #else
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <unistd.h>
 #endif
 
@@ -87,6 +107,9 @@ private:
 
 class LucasLehmerEngine {
 public:
+    static constexpr int ITERATION_BLOCK = 1024;  // Iterations per trace span
+    static constexpr double REPORT_INTERVAL = 0.1; // Seconds between progress reports within a block
+    
     struct Result {
         bool is_prime;
         double computation_time;
@@ -94,7 +117,13 @@ public:
         string status;
     };
     
-    Result test(int p, double timeout = 600.0) {
+    // Called with the iterations done since the previous call: after every
+    // iteration block, at least every REPORT_INTERVAL inside one (iterations at
+    // record exponents take seconds each) and on timeout. Returns seconds spent
+    // paused there, which don't count against the timeout.
+    using BlockHook = function<double(int iterations)>;
+    
+    Result test(int p, double timeout = 600.0, const BlockHook& on_block = nullptr) {
         auto start = high_resolution_clock::now();
         
         if (p == 2) return {true, 0.0, 0, "Known prime"};
@@ -109,16 +138,34 @@ public:
         mpz_ui_pow_ui(M, 2, p);
         mpz_sub_ui(M, M, 1);
         
-        for (int i = 0; i < p - 2; i++) {
-            auto now = high_resolution_clock::now();
-            if (duration<double>(now - start).count() > timeout) {
-                mpz_clears(s, M, temp, NULL);
-                return {false, timeout, i, "Timeout"};
-            }
+        int reported = 0;
+        auto last_report = start;
+        auto report = [&](int done, high_resolution_clock::time_point now) {
+            if (!on_block || done == reported) return;
+            double paused = on_block(done - reported);
+            start += duration_cast<high_resolution_clock::duration>(duration<double>(paused));
+            reported = done;
+            last_report = now;
+        };
+        
+        for (int block = 0; block < p - 2; block += ITERATION_BLOCK) {
+            TraceSpan span("ll_iteration_block", "ll", p);
+            int block_end = min(p - 2, block + ITERATION_BLOCK);
             
-            mpz_mul(temp, s, s);
-            mpz_sub_ui(temp, temp, 2);
-            mpz_mod(s, temp, M);
+            for (int i = block; i < block_end; i++) {
+                auto now = high_resolution_clock::now();
+                if (duration<double>(now - start).count() > timeout) {
+                    report(i, now);
+                    mpz_clears(s, M, temp, NULL);
+                    return {false, timeout, i, "Timeout"};
+                }
+                if (duration<double>(now - last_report).count() >= REPORT_INTERVAL) report(i, now);
+                
+                mpz_mul(temp, s, s);
+                mpz_sub_ui(temp, temp, 2);
+                mpz_mod(s, temp, M);
+            }
+            report(block_end, high_resolution_clock::now());
         }
         
         bool is_prime = (mpz_cmp_ui(s, 0) == 0);
@@ -133,6 +180,7 @@ public:
         for (int i = 0; i < p - 2; i++) {
             s = ((s * s) - 2) % M;
         }
+        if (on_block) on_block(p - 2);
         
         bool is_prime = (s == 0);
         #endif
@@ -161,16 +209,17 @@ public:
         int last_known = *max_element(known_exponents.begin(), known_exponents.end());
         start = max(start, last_known + 1);
         
-        for (int p = start; p <= end && candidates.size() < max_count; p += 2) {
-            if (!PrimeMath::miller_rabin(p)) continue;
-            if (p % 4 != 1 && p % 4 != 3) continue;
-            if (p % 6 != 1 && p % 6 != 5) continue;
-            if (p % 10 != 1 && p % 10 != 3 && p % 10 != 7 && p % 10 != 9) continue;
-            
-            int mod210 = p % 210;
-            if (mod210 % 2 == 0 || mod210 % 3 == 0 || mod210 % 5 == 0 || mod210 % 7 == 0) continue;
-            
-            candidates.push_back(p);
+        // Walk the compile-time mod-210 wheel: only residues coprime to 2, 3, 5, 7 reach Miller-Rabin
+        int turn = start - start % (int)tables::WHEEL_MODULUS;
+        size_t w = tables::wheel_index_at_or_after(start % tables::WHEEL_MODULUS);
+        while (candidates.size() < (size_t)max_count) {
+            if (w == tables::WHEEL_SIZE) {
+                w = 0;
+                turn += tables::WHEEL_MODULUS;
+            }
+            int p = turn + tables::WHEEL_RESIDUES[w++];
+            if (p > end) break;
+            if (PrimeMath::miller_rabin(p)) candidates.push_back(p);
         }
         
         return candidates;
@@ -183,8 +232,12 @@ private:
     CandidateGenerator generator;
     atomic<int> tests_completed{0};
     atomic<int> discoveries{0};
+    AdaptiveConcurrency* concurrency = nullptr;   // Live during run_discovery
     mutex results_mutex;
     vector<pair<int, LucasLehmerEngine::Result>> results;
+    ResultStatistics statistics;   // Aggregates over results, kept up to date as they land
+    atomic<int> confirmations_running{0};
+    vector<VerificationReport> verifications;   // Guarded by results_mutex
     
 public:
     void run_discovery(int start, int end, int max_candidates, int num_threads = 4) {
@@ -195,23 +248,62 @@ public:
         vector<thread> workers;
         atomic<size_t> candidate_index{0};
         
+        // num_threads is the ceiling; the controller finds how many of them
+        // actually raise throughput on this node right now
+        AdaptiveConcurrency controller(num_threads);
+        concurrency = &controller;
+        controller.start();
+        
         for (int t = 0; t < num_threads; t++) {
             workers.emplace_back([&, t]() {
+                TraceRecorder::instance().set_thread_name("discovery-worker-" + to_string(t));
+                ProfiledThread profiled;
                 size_t idx;
-                while ((idx = candidate_index.fetch_add(1)) < candidates.size()) {
+                for (;;) {
+                    controller.checkpoint(t);
+                    if ((idx = candidate_index.fetch_add(1)) >= candidates.size()) break;
                     int p = candidates[idx];
-                    auto result = ll_engine.test(p, 300.0);
+                    TraceRecorder::instance().record_instant("queue_pop", "queue", idx);
+                    
+                    LucasLehmerEngine::Result result;
+                    {
+                        TraceSpan span("ll_test", "discovery", p);
+                        double weight = AdaptiveConcurrency::ll_iteration_weight(p);
+                        result = ll_engine.test(p, 300.0, [&controller, t, weight](int iterations) {
+                            controller.record_work(iterations * weight);
+                            return controller.checkpoint(t);
+                        });
+                    }
                     
+                    bool reported_prime = false;
                     {
-                        lock_guard<mutex> lock(results_mutex);
+                        unique_lock<mutex> lock(results_mutex, defer_lock);
+                        {
+                            TraceSpan wait("results_mutex_wait", "lock", p);
+                            lock.lock();
+                        }
                         results.push_back({p, result});
+                        ResultRecord record;
+                        record.exponent = (uint64_t)p;
+                        record.status = result.status;
+                        record.is_prime = result.is_prime;
+                        record.seconds = result.computation_time;
+                        record.iterations = (uint64_t)result.iterations;
+                        record.host = ResultStatistics::local_host();
+                        record.ghz = ResultStatistics::local_ghz();
+                        // tf_bits stays unreported: this engine does no trial factoring
+                        statistics.record(record);
                         
                         if (result.is_prime) {
                             discoveries++;
                             save_discovery(p, result);
+                            reported_prime = true;
                         }
                     }
                     
+                    // Confirm right away on the whole node, not behind the queue
+                    if (reported_prime) confirm_discovery(p, &controller);
+                    
                     tests_completed++;
                 }
             });
@@ -220,6 +312,11 @@ public:
         for (auto& worker : workers) {
             worker.join();
         }
+        {
+            lock_guard<mutex> lock(results_mutex);
+            concurrency = nullptr;
+        }
+        controller.stop();
         
         auto end_time = high_resolution_clock::now();
         double total_time = duration<double>(end_time - start_time).count();
@@ -228,24 +325,63 @@ public:
     }
     
     string get_status_json() {
+        stringstream json;
+        write_status_json(json);
+        return json.str();
+    }
+    
+    // Any sink with stream-style << (stringstream, the HTTP server's ArenaBuffer)
+    template <typename Out>
+    void write_status_json(Out& json) {
         lock_guard<mutex> lock(results_mutex);
         
-        stringstream json;
         json << "{";
-        json << "\"tests_completed\":" << tests_completed << ",";
-        json << "\"discoveries\":" << discoveries << ",";
+        json << "\"tests_completed\":" << tests_completed.load() << ",";
+        json << "\"discoveries\":" << discoveries.load() << ",";
+        json << "\"confirmations_running\":" << confirmations_running.load() << ",";
+        if (concurrency) {
+            AdaptiveConcurrency::Snapshot c = concurrency->snapshot();
+            json << "\"active_workers\":" << c.active << ",";
+            json << "\"max_workers\":" << c.max_workers << ",";
+            json << "\"work_per_second\":" << c.work_per_second << ",";
+        }
         json << "\"engine\":\"Pure C++\",";
         json << "\"performance\":\"Prime95-equivalent\"";
         json << "}";
-        
-        return json.str();
+    }
+    
+    string get_statistics_json() const {
+        return statistics.to_json();
+    }
+    
+    template <typename Out>
+    void write_statistics_json(Out& json) const {
+        statistics.write_json(json);
+    }
+    
+    vector<ResultStatistics::Discovery> get_discoveries() const {
+        return statistics.discovery_list();
+    }
+    
+    string get_verifications_json() {
+        lock_guard<mutex> lock(results_mutex);
+        string json = "{\"verifications\":[";
+        for (size_t i = 0; i < verifications.size(); i++) {
+            if (i) json += ",";
+            json += verifications[i].to_json();
+        }
+        return json + "]}";
     }
     
     string get_images_list() {
         stringstream json;
-        json << "{\"images\":[";
-        
-        vector<string> images = {
+        write_images_json(json);
+        return json.str();
+    }
+    
+    template <typename Out>
+    void write_images_json(Out& json) {
+        static const char* const images[] = {
             "all_52_mersenne_primes.png",
             "all_perfect_numbers_complete.png",
             "benchmark_chart.png",
@@ -266,20 +402,21 @@ public:
             "perfect_numbers_graph.png",
             "prime_number_theorem_formula_proof.png"
         };
+        const size_t count = sizeof(images) / sizeof(images[0]);
         
-        for (size_t i = 0; i < images.size(); i++) {
+        json << "{\"images\":[";
+        for (size_t i = 0; i < count; i++) {
             json << "{\"name\":\"" << images[i] << "\",\"path\":\"" << images[i] << "\"}";
-            if (i < images.size() - 1) json << ",";
+            if (i < count - 1) json << ",";
         }
-        
         json << "]}";
-        return json.str();
     }
     
 
     
 private:
     void save_discovery(int p, const LucasLehmerEngine::Result& result) {
+        TraceSpan span("save_discovery", "checkpoint", p);
         ofstream file("cpp_mersenne_discoveries.txt", ios::app);
         if (file.is_open()) {
             file << "MERSENNE PRIME DISCOVERED: p=" << p << endl;
@@ -290,7 +427,32 @@ private:
         }
     }
     
+    // Suspends the other discovery workers and re-runs p on every backend
+    void confirm_discovery(int p, AdaptiveConcurrency* scheduler) {
+        TraceSpan span("confirm_discovery", "confirm", p);
+        cout << "🔬 M" << p << " reported prime - suspending background work to confirm it" << endl;
+        confirmations_running++;
+        VerificationReport report;
+        try {
+            report = ConfirmationPipeline(scheduler).confirm(p);
+        } catch (const exception& e) {
+            confirmations_running--;
+            cout << "❌ Confirmation of M" << p << " failed: " << e.what() << endl;
+            return;
+        }
+        confirmations_running--;
+        
+        cout << (report.verdict == "confirmed" ? "✅ " : "⚠️ ") << "M" << p << " " << report.verdict
+             << " by " << report.runs.size() << " independent runs in " << report.wall_seconds << "s" << endl;
+        ofstream file("cpp_mersenne_verifications.txt", ios::app);
+        if (file.is_open()) file << report.to_text();
+        
+        lock_guard<mutex> lock(results_mutex);
+        verifications.push_back(report);
+    }
+    
     void save_session_results(double total_time) {
+        TraceSpan span("save_session_results", "checkpoint");
         ofstream file("cpp_session_results.txt");
         if (file.is_open()) {
             file << "C++ Mersenne Discovery Session Results" << endl;
@@ -303,14 +465,139 @@ private:
     }
 };
 
+// One accepted socket and everything serving it needs. Pooled: the input
+// buffer and arena survive the connection, so a warm server answers from
+// memory it already owns.
+struct HttpConnection {
+    static constexpr size_t INPUT_SIZE = 16 * 1024;   // Largest request accepted (head + body)
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;   // File bodies are streamed in chunks this big
+    
+    int fd = -1;
+    char input[INPUT_SIZE];
+    size_t input_length = 0;
+    RequestArena arena{128 * 1024};
+};
+
+// Views into HttpConnection::input; valid until the connection is recycled
+struct HttpRequest {
+    string_view method, path, query, body;
+    
+    string_view param(string_view name) const {
+        string_view rest = query;
+        while (!rest.empty()) {
+            size_t amp = rest.find('&');
+            string_view pair = rest.substr(0, amp);
+            size_t eq = pair.find('=');
+            if (pair.substr(0, eq) == name) return eq == string_view::npos ? string_view() : pair.substr(eq + 1);
+            if (amp == string_view::npos) break;
+            rest.remove_prefix(amp + 1);
+        }
+        return string_view();
+    }
+};
+
+// Body written straight after HEADER_ROOM reserved bytes of the same arena
+// buffer; finish() formats the head into that gap so head and body go out in
+// one send. File bodies are not buffered: the server streams them from file_fd.
+class HttpResponse {
+private:
+    static constexpr size_t HEADER_ROOM = 512;
+    ArenaBuffer buffer;
+    int status = 200;
+    const char* reason = "OK";
+    const char* content_type = "text/plain";
+    char extra[256];
+    size_t extra_length = 0;
+    
+public:
+    int file_fd = -1;
+    uint64_t file_size = 0;
+    
+    explicit HttpResponse(RequestArena& arena) : buffer(arena, 4096) {
+        buffer.resize(HEADER_ROOM);
+    }
+    
+    ArenaBuffer& body() { return buffer; }
+    size_t body_size() const { return buffer.size() - HEADER_ROOM; }
+    
+    void set(int code, const char* code_reason, const char* type) {
+        status = code;
+        reason = code_reason;
+        content_type = type;
+    }
+    
+    // Drops anything written so far, e.g. when a handler fails part way
+    void clear() {
+        buffer.resize(HEADER_ROOM);
+        extra_length = 0;
+    }
+    
+    void header(string_view name, string_view value) {
+        size_t needed = name.size() + value.size() + 4;
+        if (extra_length + needed > sizeof(extra)) throw length_error("HTTP response headers too long");
+        char* out = extra + extra_length;
+        memcpy(out, name.data(), name.size());
+        out += name.size();
+        memcpy(out, ": ", 2);
+        memcpy(out + 2, value.data(), value.size());
+        memcpy(out + 2 + value.size(), "\r\n", 2);
+        extra_length += needed;
+    }
+    
+    // Status line and headers followed by the buffered body
+    string_view finish() {
+        uint64_t length = file_fd >= 0 ? file_size : body_size();
+        char head[HEADER_ROOM];
+        int n = snprintf(head, sizeof(head),
+                         "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %llu\r\n%.*sConnection: close\r\n\r\n",
+                         status, reason, content_type, (unsigned long long)length, (int)extra_length, extra);
+        if (n < 0 || (size_t)n >= sizeof(head)) throw length_error("HTTP response head exceeds header room");
+        char* start = buffer.data() + HEADER_ROOM - n;
+        memcpy(start, head, n);
+        return string_view(start, n + body_size());
+    }
+};
+
 class HTTPServer {
 private:
+    static constexpr size_t QUEUE_SIZE = 256;
+    
     MersenneDiscoveryEngine* engine;
     int port;
     atomic<bool> running{false};
     
+    // Accepted connections waiting for a worker: a fixed ring, so handing one
+    // over never allocates. The acceptor blocks while it is full.
+    SlabPool<HttpConnection> connections;
+    mutex queue_mutex;
+    condition_variable queue_ready, queue_space;
+    HttpConnection* queue[QUEUE_SIZE];
+    size_t queue_head = 0, queue_count = 0;
+    vector<thread> workers;
+    
+    // LL test requests can hold a worker for up to a minute: only this many
+    // run at once so the rest of the pool keeps serving; others get a 503
+    atomic<int> long_tests{0};
+    const int long_test_limit;
+    
+    // A client that stalls mid-request or stops reading frees its worker after this
+    static constexpr int SOCKET_TIMEOUT_SECONDS = 15;
+    
+    static int worker_count() {
+        const char* env = getenv("MERSENNE_HTTP_THREADS");
+        int n = env ? atoi(env) : 0;
+        return n > 0 ? n : 16;
+    }
+    
+    static int long_test_count() {
+        const char* env = getenv("MERSENNE_HTTP_LONG_TESTS");
+        int n = env ? atoi(env) : 0;
+        return n > 0 ? n : max(1, worker_count() / 4);
+    }
+    
 public:
-    HTTPServer(MersenneDiscoveryEngine* eng, int p = 8080) : engine(eng), port(p) {}
+    HTTPServer(MersenneDiscoveryEngine* eng, int p = 8080)
+        : engine(eng), port(p), connections((size_t)worker_count()), long_test_limit(long_test_count()) {}
     
     void start() {
         #ifdef _WIN32
@@ -340,13 +627,18 @@ public:
             return;
         }
         
-        if (listen(server_fd, 3) < 0) {
+        if (listen(server_fd, 128) < 0) {
             cout << "❌ Listen failed" << endl;
             return;
         }
         
         running = true;
-        cout << "🚀 C++ HTTP Server running on port " << port << endl;
+        int threads = worker_count();
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back(&HTTPServer::serve_connections, this, i);
+        }
+        
+        cout << "🚀 C++ HTTP Server running on port " << port << " (" << threads << " workers)" << endl;
         cout << "🌐 Web interface: http://localhost:" << port << endl;
         cout << "✅ System ready - Pure C++ with zero dependencies" << endl;
         
@@ -356,10 +648,23 @@ public:
             int client_fd = accept(server_fd, (sockaddr*)&client_addr, (socklen_t*)&client_len);
             
             if (client_fd >= 0) {
-                thread(&HTTPServer::handle_request, this, client_fd).detach();
+                int nodelay = 1;
+                setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, (char*)&nodelay, sizeof(nodelay));
+                set_socket_timeouts(client_fd);
+                HttpConnection* connection = connections.acquire();
+                connection->fd = client_fd;
+                connection->input_length = 0;
+                enqueue(connection);
             }
         }
         
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            queue_ready.notify_all();
+        }
+        for (thread& worker : workers) worker.join();
+        workers.clear();
+        
         #ifdef _WIN32
         closesocket(server_fd);
         WSACleanup();
@@ -369,320 +674,553 @@ public:
     }
     
 private:
-    void handle_request(int client_fd) {
-        char buffer[1024] = {0};
-        recv(client_fd, buffer, 1024, 0);
+    void enqueue(HttpConnection* connection) {
+        unique_lock<mutex> lock(queue_mutex);
+        queue_space.wait(lock, [this] { return queue_count < QUEUE_SIZE; });
+        queue[(queue_head + queue_count) % QUEUE_SIZE] = connection;
+        queue_count++;
+        queue_ready.notify_one();
+    }
+    
+    // Next queued connection, or nullptr once the server stops
+    HttpConnection* dequeue() {
+        unique_lock<mutex> lock(queue_mutex);
+        queue_ready.wait(lock, [this] { return queue_count > 0 || !running; });
+        if (queue_count == 0) return nullptr;
+        HttpConnection* connection = queue[queue_head];
+        queue_head = (queue_head + 1) % QUEUE_SIZE;
+        queue_count--;
+        queue_space.notify_one();
+        return connection;
+    }
+    
+    void serve_connections(int id) {
+        TraceRecorder::instance().set_thread_name("http-worker-" + to_string(id));
+        ProfiledThread profiled;
+        while (HttpConnection* connection = dequeue()) {
+            handle_request(*connection);
+            close_socket(connection->fd);
+            connection->fd = -1;
+            connection->arena.reset();
+            connections.release(connection);
+        }
+    }
+    
+    static void set_socket_timeouts(int fd) {
+        #ifdef _WIN32
+        DWORD timeout = SOCKET_TIMEOUT_SECONDS * 1000;
+        #else
+        timeval timeout{SOCKET_TIMEOUT_SECONDS, 0};
+        #endif
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeout, sizeof(timeout));
+    }
+    
+    static void close_socket(int fd) {
+        #ifdef _WIN32
+        closesocket(fd);
+        #else
+        close(fd);
+        #endif
+    }
+    
+    static bool send_all(int fd, const char* data, size_t length) {
+        #ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;   // A client hanging up must not raise SIGPIPE
+        #else
+        const int flags = 0;
+        #endif
+        while (length > 0) {
+            int chunk = (int)min<size_t>(length, 1 << 30);
+            int sent = (int)send(fd, data, chunk, flags);
+            if (sent <= 0) return false;
+            data += sent;
+            length -= sent;
+        }
+        return true;
+    }
+    
+    // Reads until the head and any Content-Length body are in. Returns 0 when
+    // the request is complete, otherwise the status to refuse it with (-1: the
+    // client went away).
+    static int read_request(HttpConnection& c, HttpRequest& request) {
+        size_t head_end = string_view::npos;
+        size_t content_length = 0;
+        for (;;) {
+            if (head_end == string_view::npos) {
+                head_end = string_view(c.input, c.input_length).find("\r\n\r\n");
+                if (head_end != string_view::npos && !parse_head(c, head_end, request, content_length)) return 400;
+            }
+            if (head_end != string_view::npos) {
+                // Compared before adding: a huge Content-Length must not wrap the total
+                if (content_length > HttpConnection::INPUT_SIZE - (head_end + 4)) return 413;
+                size_t total = head_end + 4 + content_length;
+                if (c.input_length >= total) {
+                    request.body = string_view(c.input + head_end + 4, content_length);
+                    return 0;
+                }
+            } else if (c.input_length == HttpConnection::INPUT_SIZE) {
+                return 413;
+            }
+            int n = (int)recv(c.fd, c.input + c.input_length, (int)(HttpConnection::INPUT_SIZE - c.input_length), 0);
+            if (n <= 0) return -1;
+            c.input_length += n;
+        }
+    }
+    
+    static bool parse_head(HttpConnection& c, size_t head_end, HttpRequest& request, size_t& content_length) {
+        string_view head(c.input, head_end);
+        size_t line_end = head.find("\r\n");
+        string_view line = head.substr(0, line_end);
+        
+        size_t sp1 = line.find(' ');
+        if (sp1 == string_view::npos) return false;
+        size_t sp2 = line.find(' ', sp1 + 1);
+        request.method = line.substr(0, sp1);
+        string_view target = line.substr(sp1 + 1, sp2 == string_view::npos ? string_view::npos : sp2 - sp1 - 1);
+        size_t question = target.find('?');
+        request.path = target.substr(0, question);
+        request.query = question == string_view::npos ? string_view() : target.substr(question + 1);
+        if (request.path.empty() || request.path[0] != '/') return false;
+        
+        content_length = 0;
+        while (line_end != string_view::npos) {
+            size_t start = line_end + 2;
+            line_end = head.find("\r\n", start);
+            line = head.substr(start, line_end == string_view::npos ? string_view::npos : line_end - start);
+            size_t colon = line.find(':');
+            if (colon != 14 || !equals_ignore_case(line.substr(0, colon), "content-length")) continue;
+            string_view value = line.substr(colon + 1);
+            while (!value.empty() && value[0] == ' ') value.remove_prefix(1);
+            if (from_chars(value.data(), value.data() + value.size(), content_length).ec != errc()) return false;
+        }
+        return true;
+    }
+    
+    static bool equals_ignore_case(string_view a, string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+    
+    void handle_request(HttpConnection& c) {
+        TraceSpan span("http_request", "http", c.fd);
+        HttpRequest request;
+        HttpResponse response(c.arena);
+        
+        int refused = read_request(c, request);
+        if (refused < 0) return;
+        if (refused == 413) {
+            text_response(response, 413, "Payload Too Large", "Request Too Large");
+        } else if (refused) {
+            text_response(response, 400, "Bad Request", "Bad Request");
+        } else {
+            try {
+                route(request, response);
+            } catch (const exception& e) {
+                response.clear();
+                response.set(500, "Internal Server Error", "application/json");
+                response.body() << "{\"error\":";
+                write_json_string(response.body(), e.what());
+                response.body() << "}";
+            }
+        }
         
-        string request(buffer);
-        string response;
+        string_view out = response.finish();
+        bool sent = send_all(c.fd, out.data(), out.size());
+        if (response.file_fd >= 0) {
+            if (sent) stream_file(c, response.file_fd);
+            close_file(response.file_fd);
+        }
+    }
+    
+    void route(const HttpRequest& request, HttpResponse& response) {
+        const string_view path = request.path;
         
-        if (request.find("POST /") == 0) {
+        if (request.method == "POST") {
             // Handle POST requests for API endpoints
-            if (request.find("POST /api/test_mersenne") != string::npos) {
+            if (path == "/api/test_mersenne") {
                 cout << "POST test_mersenne request received" << endl;
-                response = create_json_response(handle_post_test_mersenne(request));
-            } else if (request.find("POST /api/find_perfect_numbers") != string::npos) {
+                run_long_test(response, [&](ArenaBuffer& json) { handle_post_test_mersenne(request, json); });
+            } else if (path == "/api/find_perfect_numbers") {
                 cout << "POST find_perfect_numbers request received" << endl;
-                response = create_json_response(handle_post_perfect_numbers(request));
-            } else if (request.find("POST /api/performance_test") != string::npos) {
+                handle_post_perfect_numbers(request, json_response(response));
+            } else if (path == "/api/performance_test") {
                 cout << "POST performance_test request received" << endl;
-                response = create_json_response(handle_post_performance_test(request));
-            } else if (request.find("POST /api/queue_mersenne") != string::npos) {
+                handle_post_performance_test(request, json_response(response));
+            } else if (path == "/api/queue_mersenne") {
                 cout << "POST queue_mersenne request received" << endl;
-                response = create_json_response(handle_post_queue_mersenne(request));
+                handle_post_queue_mersenne(request, json_response(response));
             } else {
-                response = "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nNot Found";
+                text_response(response, 404, "Not Found", "Not Found");
             }
-        } else if (request.find("GET /") == 0) {
-            if (request.find("GET /api/status") != string::npos) {
-                response = create_json_response(engine->get_status_json());
-            } else if (request.find("GET /api/test") != string::npos) {
-                response = create_json_response(test_mersenne_api(request));
-            } else if (request.find("GET /api/test_mersenne") != string::npos) {
-                response = create_json_response(test_mersenne_api(request));
-            } else if (request.find("GET /api/find_perfect_numbers") != string::npos) {
-                response = create_json_response("{\"perfect_numbers\":[{\"exponent\":3,\"mersenne_prime\":7,\"digits\":1},{\"exponent\":5,\"mersenne_prime\":31,\"digits\":2}]}");
-
-            } else if (request.find("GET /api/performance_test") != string::npos) {
-                response = create_json_response("{\"results\":[{\"exponent\":31,\"is_prime\":true,\"computation_time\":0.001}],\"average_time\":0.001,\"total_time\":0.001,\"total_tested\":1}");
-            } else if (request.find("GET /api/queue_mersenne") != string::npos) {
-                response = create_json_response("{\"queued\":0,\"mode\":\"LL\",\"worktodo\":\"Not configured\"}");
-            } else if (request.find("GET /api/images") != string::npos) {
-                response = create_json_response(engine->get_images_list());
-            } else if (request.find("GET /api/run_analysis") != string::npos) {
-                response = create_json_response(handle_run_analysis());
-            } else if (request.find("GET /api/progress") != string::npos) {
-                response = create_json_response(handle_progress_api());
-            } else if (request.find("GET /assets/") != string::npos) {
-                response = serve_file(request, "assets/");
-            } else if (request.find("GET /images/") != string::npos) {
-                response = serve_file(request, "archived_png_files/");
-            } else if (request.find("GET /proofs/") != string::npos) {
-                response = serve_file(request, "proofs/");
-            } else if (request.find("GET /research-paper") != string::npos) {
-                response = serve_pdf("MERSENNE_PROJECT_ANALYSIS.pdf");
-            } else if (request.find("GET /research-analysis") != string::npos) {
-                response = serve_pdf("research_analysis.pdf");
-            } else if (request.find("GET /download-research") != string::npos) {
-                response = serve_download("MERSENNE_PROJECT_ANALYSIS.pdf");
-            } else if (request.find("GET /download-research-analysis") != string::npos) {
-                response = serve_download("research_analysis.pdf");
+        } else if (request.method == "GET") {
+            if (path == "/api/status") {
+                engine->write_status_json(json_response(response));
+            } else if (path == "/api/test" || path == "/api/test_mersenne") {
+                run_long_test(response, [&](ArenaBuffer& json) { test_mersenne_api(request, json); });
+            } else if (path == "/api/find_perfect_numbers") {
+                json_response(response) << "{\"perfect_numbers\":[{\"exponent\":3,\"mersenne_prime\":7,\"digits\":1},{\"exponent\":5,\"mersenne_prime\":31,\"digits\":2}]}";
+            } else if (path == "/api/performance_test") {
+                json_response(response) << "{\"results\":[{\"exponent\":31,\"is_prime\":true,\"computation_time\":0.001}],\"average_time\":0.001,\"total_time\":0.001,\"total_tested\":1}";
+            } else if (path == "/api/queue_mersenne") {
+                json_response(response) << "{\"queued\":0,\"mode\":\"LL\",\"worktodo\":\"Not configured\"}";
+            } else if (path == "/api/images") {
+                engine->write_images_json(json_response(response));
+            } else if (path == "/api/verifications") {
+                json_response(response) << engine->get_verifications_json();
+            } else if (path == "/api/statistics") {
+                engine->write_statistics_json(json_response(response));
+            } else if (path == "/api/run_analysis") {
+                json_response(response) << handle_run_analysis();
+            } else if (path == "/api/progress") {
+                handle_progress_api(json_response(response));
+            } else if (path == "/api/trace") {
+                json_response(response) << TraceRecorder::instance().export_chrome_json();
+            } else if (path == "/api/profile") {
+                text_response(response, 200, "OK", SamplingProfiler::instance().is_enabled()
+                    ? SamplingProfiler::instance().export_folded()
+                    : "Profiler disabled - restart with MERSENNE_PROFILE=1\n");
+            } else if (path.rfind("/assets/", 0) == 0) {
+                serve_file(response, "assets/", path.substr(8));
+            } else if (path.rfind("/images/", 0) == 0) {
+                serve_file(response, "archived_png_files/", path.substr(8));
+            } else if (path.rfind("/proofs/", 0) == 0) {
+                serve_file(response, "proofs/", path.substr(8));
+            } else if (path == "/research-paper") {
+                serve_pdf(response, "MERSENNE_PROJECT_ANALYSIS.pdf");
+            } else if (path == "/research-analysis") {
+                serve_pdf(response, "research_analysis.pdf");
+            } else if (path == "/download-research") {
+                serve_download(response, "MERSENNE_PROJECT_ANALYSIS.pdf");
+            } else if (path == "/download-research-analysis") {
+                serve_download(response, "research_analysis.pdf");
             } else {
-                response = create_html_response();
+                create_html_response(response);
             }
+        } else {
+            text_response(response, 405, "Method Not Allowed", "Method Not Allowed");
         }
-        
-        send(client_fd, response.c_str(), response.length(), 0);
-        
+    }
+    
+    // Runs an LL test handler in one of the long-test slots, or answers 503 when all are taken
+    template <typename Handler>
+    void run_long_test(HttpResponse& response, Handler handler) {
+        if (long_tests.fetch_add(1) >= long_test_limit) {
+            long_tests--;
+            response.set(503, "Service Unavailable", "application/json");
+            response.header("Access-Control-Allow-Origin", "*");
+            response.header("Retry-After", "30");
+            response.body() << "{\"error\":\"Too many tests running - retry shortly\"}";
+            return;
+        }
+        struct Slot {
+            atomic<int>& running;
+            ~Slot() { running--; }
+        } slot{long_tests};
+        handler(json_response(response));
+    }
+    
+    static ArenaBuffer& json_response(HttpResponse& response) {
+        response.set(200, "OK", "application/json");
+        response.header("Access-Control-Allow-Origin", "*");
+        return response.body();
+    }
+    
+    static void text_response(HttpResponse& response, int status, const char* reason, string_view text) {
+        response.set(status, reason, "text/plain");
+        response.body() << text;
+    }
+    
+    // ========================================
+    // STATIC FILES
+    // ========================================
+    // Opened with the POSIX calls (no ifstream / string buffers) and streamed
+    // through the connection's arena in CHUNK_SIZE pieces
+    
+    static int open_file(const char* path, uint64_t& size) {
+        #ifdef _WIN32
+        int fd = _open(path, _O_RDONLY | _O_BINARY);
+        if (fd < 0) return -1;
+        struct _stat64 info;
+        if (_fstat64(fd, &info) != 0 || !(info.st_mode & _S_IFREG)) {
+            _close(fd);
+            return -1;
+        }
+        #else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return -1;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            return -1;
+        }
+        #endif
+        size = (uint64_t)info.st_size;
+        return fd;
+    }
+    
+    static void close_file(int fd) {
         #ifdef _WIN32
-        closesocket(client_fd);
+        _close(fd);
         #else
-        close(client_fd);
+        close(fd);
         #endif
     }
     
-    string create_html_response() {
-        // Read the complete HTML template
-        ifstream file("templates/index.html");
-        if (!file.is_open()) {
+    static void stream_file(HttpConnection& c, int fd) {
+        char* chunk = static_cast<char*>(c.arena.allocate(HttpConnection::CHUNK_SIZE, 16));
+        for (;;) {
+            #ifdef _WIN32
+            int n = _read(fd, chunk, (unsigned)HttpConnection::CHUNK_SIZE);
+            #else
+            ssize_t n = read(fd, chunk, HttpConnection::CHUNK_SIZE);
+            #endif
+            if (n <= 0 || !send_all(c.fd, chunk, (size_t)n)) return;
+        }
+    }
+    
+    static bool ends_with(string_view s, string_view suffix) {
+        return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+    }
+    
+    static const char* content_type_for(string_view path) {
+        if (ends_with(path, ".png")) return "image/png";
+        if (ends_with(path, ".jpg") || ends_with(path, ".jpeg")) return "image/jpeg";
+        if (ends_with(path, ".pdf")) return "application/pdf";
+        if (ends_with(path, ".html")) return "text/html";
+        if (ends_with(path, ".css")) return "text/css";
+        if (ends_with(path, ".js")) return "application/javascript";
+        return "application/octet-stream";
+    }
+    
+    // Attaches base + name as the file body; false if it can't be served
+    static bool attach_file(HttpResponse& response, string_view base, string_view name, const char* type) {
+        char path[512];
+        if (name.empty() || base.size() + name.size() >= sizeof(path) || name.find("..") != string_view::npos) return false;
+        memcpy(path, base.data(), base.size());
+        memcpy(path + base.size(), name.data(), name.size());
+        path[base.size() + name.size()] = '\0';
+        
+        uint64_t size = 0;
+        int fd = open_file(path, size);
+        if (fd < 0) return false;
+        response.set(200, "OK", type);
+        response.file_fd = fd;
+        response.file_size = size;
+        return true;
+    }
+    
+    void create_html_response(HttpResponse& response) {
+        // The template is read on every request so edits show up without a restart
+        if (!attach_file(response, "templates/", "index.html", "text/html")) {
             // Fallback simple HTML if template not found
-            string html = "<html><body><h1>C++ Mersenne System</h1><p>Template not found</p></body></html>";
-            return "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: " + 
-                   to_string(html.length()) + "\r\n\r\n" + html;
+            response.set(200, "OK", "text/html");
+            response.body() << "<html><body><h1>C++ Mersenne System</h1><p>Template not found</p></body></html>";
         }
-        
-        string html((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-        file.close();
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: " + 
-               to_string(html.length()) + "\r\n\r\n" + html;
     }
     
-    string create_json_response(const string& json) {
-        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nAccess-Control-Allow-Origin: *\r\nContent-Length: " + 
-               to_string(json.length()) + "\r\n\r\n" + json;
+    void serve_file(HttpResponse& response, string_view base_path, string_view name) {
+        if (!attach_file(response, base_path, name, content_type_for(name))) {
+            text_response(response, 404, "Not Found", "Not Found");
+            return;
+        }
+        response.header("Cache-Control", "public, max-age=3600");
     }
     
-    string serve_file(const string& request, const string& base_path) {
-        // Extract filename from request
-        size_t start = request.find("GET /") + 4;
-        size_t end = request.find(" ", start);
-        if (end == string::npos) end = request.find("\r", start);
-        if (end == string::npos) end = request.length();
-        
-        string path = request.substr(start, end - start);
-        string actual_path;
-        
-        // Construct actual file path based on request
-        if (path.find("assets/") == 0) {
-            actual_path = path; // Keep as is for assets
-        } else if (path.find("images/") == 0) {
-            // Extract filename after images/
-            string filename = path.substr(7); // Remove "images/"
-            actual_path = "archived_png_files/" + filename;
-        } else if (path.find("proofs/") == 0) {
-            actual_path = path; // Keep as is for proofs
-        } else {
-            actual_path = path;
+    void serve_pdf(HttpResponse& response, const char* filename) {
+        if (!attach_file(response, "", filename, "application/pdf")) {
+            text_response(response, 404, "Not Found", "PDF Not Found");
+            return;
         }
-        
-        ifstream file(actual_path, ios::binary);
-        if (!file.is_open()) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nNot Found";
+        serve_as(response, "inline", filename);
+    }
+    
+    void serve_download(HttpResponse& response, const char* filename) {
+        if (!attach_file(response, "", filename, "application/octet-stream")) {
+            text_response(response, 404, "Not Found", "File Not Found");
+            return;
         }
-        
-        string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-        file.close();
-        
-        string content_type = "application/octet-stream";
-        if (actual_path.find(".png") != string::npos) content_type = "image/png";
-        else if (actual_path.find(".jpg") != string::npos || actual_path.find(".jpeg") != string::npos) content_type = "image/jpeg";
-        else if (actual_path.find(".pdf") != string::npos) content_type = "application/pdf";
-        else if (actual_path.find(".html") != string::npos) content_type = "text/html";
-        else if (actual_path.find(".css") != string::npos) content_type = "text/css";
-        else if (actual_path.find(".js") != string::npos) content_type = "application/javascript";
-        
-        return "HTTP/1.1 200 OK\r\nContent-Type: " + content_type + 
-               "\r\nContent-Length: " + to_string(content.length()) + 
-               "\r\nCache-Control: public, max-age=3600\r\n\r\n" + content;
+        serve_as(response, "attachment", filename);
+    }
+    
+    static void serve_as(HttpResponse& response, string_view disposition, string_view filename) {
+        char value[256];
+        int n = snprintf(value, sizeof(value), "%.*s; filename=\"%.*s\"", (int)disposition.size(), disposition.data(),
+                         (int)filename.size(), filename.data());
+        response.header("Content-Disposition", string_view(value, (size_t)max(0, min(n, (int)sizeof(value) - 1))));
+    }
+    
+    // ========================================
+    // API HANDLERS
+    // ========================================
+    
+    static bool parse_int(string_view text, int& value) {
+        auto result = from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == errc() && result.ptr == text.data() + text.size();
     }
     
-    string serve_pdf(const string& filename) {
-        ifstream file(filename, ios::binary);
-        if (!file.is_open()) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Length: 13\r\n\r\nPDF Not Found";
+    void test_mersenne_api(const HttpRequest& request, ArenaBuffer& json) {
+        // Extract p parameter from URL
+        string_view p_str = request.param("p");
+        if (p_str.empty()) {
+            json << "{\"error\":\"Missing parameter p\"}";
+            return;
         }
         
-        string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-        file.close();
+        int p = 0;
+        if (!parse_int(p_str, p)) {
+            json << "{\"error\":\"Invalid parameter: p\"}";
+            return;
+        }
         
-        return string("HTTP/1.1 200 OK\r\nContent-Type: application/pdf\r\n") +
-               string("Content-Length: ") + to_string(content.length()) + 
-               string("\r\nContent-Disposition: inline; filename=\"") + filename + string("\"\r\n\r\n") + content;
-    }
-    
-    string serve_download(const string& filename) {
-        ifstream file(filename, ios::binary);
-        if (!file.is_open()) {
-            return "HTTP/1.1 404 Not Found\r\nContent-Length: 13\r\n\r\nFile Not Found";
+        if (p < 2) {
+            json << "{\"error\":\"Exponent must be >= 2\"}";
+            return;
+        }
+        
+        if (p > 100000) {
+            json << "{\"error\":\"Exponent too large for web interface (max 100000)\"}";
+            return;
         }
         
-        string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-        file.close();
+        LucasLehmerEngine test_engine;
+        auto result = test_engine.test(p, 60.0);
         
-        return string("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\n") +
-               string("Content-Length: ") + to_string(content.length()) + 
-               string("\r\nContent-Disposition: attachment; filename=\"") + filename + string("\"\r\n\r\n") + content;
+        json << "{";
+        json << "\"exponent\":" << p << ",";
+        json << "\"is_prime\":" << (result.is_prime ? "true" : "false") << ",";
+        json << "\"computation_time\":" << result.computation_time << ",";
+        json << "\"iterations\":" << result.iterations << ",";
+        json << "\"status\":\"" << result.status << "\",";
+        json << "\"engine\":\"Pure C++\",";
+        json << "\"performance\":\"Prime95-equivalent\"";
+        json << "}";
     }
     
-    string test_mersenne_api(const string& request) {
-        try {
-            // Extract p parameter from URL
-            size_t p_pos = request.find("p=");
-            if (p_pos == string::npos) {
-                return "{\"error\":\"Missing parameter p\"}";
-            }
-            
-            size_t end_pos = request.find(" ", p_pos);
-            if (end_pos == string::npos) end_pos = request.find("\r", p_pos);
-            if (end_pos == string::npos) end_pos = request.length();
-            
-            string p_str = request.substr(p_pos + 2, end_pos - p_pos - 2);
-            int p = stoi(p_str);
-            
-            if (p < 2) {
-                return "{\"error\":\"Exponent must be >= 2\"}";
-            }
-            
-            if (p > 100000) {
-                return "{\"error\":\"Exponent too large for web interface (max 100000)\"}";
-            }
-            
-            LucasLehmerEngine test_engine;
-            auto result = test_engine.test(p, 60.0);
-            
-            stringstream json;
-            json << "{";
-            json << "\"exponent\":" << p << ",";
-            json << "\"is_prime\":" << (result.is_prime ? "true" : "false") << ",";
-            json << "\"computation_time\":" << result.computation_time << ",";
-            json << "\"iterations\":" << result.iterations << ",";
-            json << "\"status\":\"" << result.status << "\",";
-            json << "\"engine\":\"Pure C++\",";
-            json << "\"performance\":\"Prime95-equivalent\"";
-            json << "}";
-            
-            return json.str();
-            
-        } catch (const exception& e) {
-            return "{\"error\":\"Invalid parameter: " + string(e.what()) + "\"}";
+    void handle_post_test_mersenne(const HttpRequest& request, ArenaBuffer& json) {
+        string_view body = request.body;
+        if (body.empty()) {
+            json << "{\"error\":\"No body\"}";
+            return;
         }
-    }
-    
-    string handle_post_test_mersenne(const string& request) {
-        size_t body_start = request.find("\r\n\r\n");
-        if (body_start == string::npos) return "{\"error\":\"No body\"}";
         
-        string body = request.substr(body_start + 4);
         size_t exp_pos = body.find("\"exponent\"");
-        if (exp_pos == string::npos) return "{\"error\":\"Missing exponent\"}";
+        if (exp_pos == string_view::npos) {
+            json << "{\"error\":\"Missing exponent\"}";
+            return;
+        }
         
         size_t colon_pos = body.find(":", exp_pos);
         size_t num_start = body.find_first_of("0123456789", colon_pos);
-        if (num_start == string::npos) return "{\"error\":\"Invalid format\"}";
-        
-        size_t num_end = body.find_first_not_of("0123456789", num_start);
-        int p = stoi(body.substr(num_start, num_end - num_start));
+        int p = 0;
+        if (num_start == string_view::npos ||
+            from_chars(body.data() + num_start, body.data() + body.size(), p).ec != errc()) {
+            json << "{\"error\":\"Invalid format\"}";
+            return;
+        }
         
-        if (p < 2 || p > 10000) return "{\"error\":\"Invalid range\"}";
+        if (p < 2 || p > 10000) {
+            json << "{\"error\":\"Invalid range\"}";
+            return;
+        }
         
         LucasLehmerEngine test_engine;
         auto result = test_engine.test(p, 30.0);
         
-        return "{\"exponent\":" + to_string(p) + ",\"digits\":" + to_string((int)(p * 0.30103)) + ",\"is_prime\":" + (result.is_prime ? "true" : "false") + ",\"computation_time\":" + to_string(result.computation_time) + "}";
+        json << "{\"exponent\":" << p << ",\"digits\":" << (int)(p * 0.30103) << ",\"is_prime\":"
+             << (result.is_prime ? "true" : "false") << ",\"computation_time\":" << result.computation_time << "}";
     }
     
-    string handle_post_perfect_numbers(const string& request) {
-        return "{\"perfect_numbers\":[{\"exponent\":3,\"mersenne_prime\":7,\"perfect_number\":6,\"digits\":1},{\"exponent\":5,\"mersenne_prime\":31,\"perfect_number\":496,\"digits\":2}]}";
+    void handle_post_perfect_numbers(const HttpRequest& request, ArenaBuffer& json) {
+        json << "{\"perfect_numbers\":[{\"exponent\":3,\"mersenne_prime\":7,\"perfect_number\":6,\"digits\":1},{\"exponent\":5,\"mersenne_prime\":31,\"perfect_number\":496,\"digits\":2}]}";
     }
     
-    string handle_post_performance_test(const string& request) {
-        vector<int> test_primes = {3, 5, 7, 13, 17};
+    void handle_post_performance_test(const HttpRequest& request, ArenaBuffer& json) {
+        static const int test_primes[] = {3, 5, 7, 13, 17};
+        const size_t count = sizeof(test_primes) / sizeof(test_primes[0]);
         LucasLehmerEngine test_engine;
-        string results = "[";
         double total_time = 0;
         
-        for (size_t i = 0; i < test_primes.size(); i++) {
+        json << "{\"results\":[";
+        for (size_t i = 0; i < count; i++) {
             auto result = test_engine.test(test_primes[i], 10.0);
             total_time += result.computation_time;
             
-            results += "{\"exponent\":" + to_string(test_primes[i]) + ",\"is_prime\":" + (result.is_prime ? "true" : "false") + ",\"computation_time\":" + to_string(result.computation_time) + "}";
-            if (i < test_primes.size() - 1) results += ",";
+            json << "{\"exponent\":" << test_primes[i] << ",\"is_prime\":" << (result.is_prime ? "true" : "false")
+                 << ",\"computation_time\":" << result.computation_time << "}";
+            if (i < count - 1) json << ",";
         }
-        
-        results += "]";
-        return "{\"results\":" + results + ",\"total_tested\":" + to_string(test_primes.size()) + ",\"total_time\":" + to_string(total_time) + ",\"average_time\":" + to_string(total_time / test_primes.size()) + "}";
+        json << "],\"total_tested\":" << count << ",\"total_time\":" << total_time
+             << ",\"average_time\":" << total_time / count << "}";
     }
     
-    string handle_post_queue_mersenne(const string& request) {
-        // Extract exponents from request body
-        size_t body_start = request.find("\r\n\r\n");
-        if (body_start == string::npos) return "{\"error\":\"No body\"}";
-        
-        string body = request.substr(body_start + 4);
+    void handle_post_queue_mersenne(const HttpRequest& request, ArenaBuffer& json) {
+        if (request.body.empty()) {
+            json << "{\"error\":\"No body\"}";
+            return;
+        }
         
         // Simple response for demo
-        return "{\"queued\":1,\"mode\":\"LL\",\"worktodo\":\"worktodo.txt\",\"message\":\"Exponents queued for testing\"}";
+        json << "{\"queued\":1,\"mode\":\"LL\",\"worktodo\":\"worktodo.txt\",\"message\":\"Exponents queued for testing\"}";
     }
     
-    string get_current_time() {
-        auto now = chrono::system_clock::now();
-        auto time_t = chrono::system_clock::to_time_t(now);
-        return "2024-01-01 12:00:00";
+    // Local time as "YYYY-MM-DD HH:MM:SS"
+    static void write_current_time(ArenaBuffer& out) {
+        time_t now = chrono::system_clock::to_time_t(chrono::system_clock::now());
+        tm local{};
+        #ifdef _WIN32
+        localtime_s(&local, &now);
+        #else
+        localtime_r(&now, &local);
+        #endif
+        char text[32];
+        out.append(text, strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local));
     }
     
     string handle_run_analysis() {
-        // Simulate comprehensive analysis
-        vector<int> known_primes = {3, 5, 7, 13, 17, 19, 31, 61, 89, 107};
-        vector<int> gaps;
+        auto start = high_resolution_clock::now();
         
-        for (size_t i = 1; i < known_primes.size(); i++) {
-            gaps.push_back(known_primes[i] - known_primes[i-1]);
-        }
+        // Gap patterns over what this engine has actually found; everything
+        // else comes from the incrementally maintained aggregates
+        vector<ResultStatistics::Discovery> found = engine->get_discoveries();
+        vector<uint64_t> exponents;
+        for (const auto& d : found) exponents.push_back(d.exponent);
+        sort(exponents.begin(), exponents.end());
         
+        uint64_t largest_gap = 0, smallest_gap = 0;
         double avg_gap = 0;
-        for (int gap : gaps) avg_gap += gap;
-        avg_gap /= gaps.size();
+        for (size_t i = 1; i < exponents.size(); i++) {
+            uint64_t gap = exponents[i] - exponents[i-1];
+            largest_gap = max(largest_gap, gap);
+            smallest_gap = i == 1 ? gap : min(smallest_gap, gap);
+            avg_gap += gap;
+        }
+        if (exponents.size() > 1) avg_gap /= exponents.size() - 1;
         
         stringstream json;
         json << "{";
         json << "\"patterns\":{";
-        json << "\"total_known\":" << known_primes.size() << ",";
+        json << "\"total_known\":" << exponents.size() << ",";
+        json << "\"largest_known\":" << (exponents.empty() ? 0 : exponents.back()) << ",";
         json << "\"average_gap\":" << avg_gap << ",";
-        json << "\"largest_gap\":" << *max_element(gaps.begin(), gaps.end()) << ",";
-        json << "\"smallest_gap\":" << *min_element(gaps.begin(), gaps.end());
+        json << "\"largest_gap\":" << largest_gap << ",";
+        json << "\"smallest_gap\":" << smallest_gap;
         json << "},";
-        json << "\"perfect_numbers\":[";
-        for (size_t i = 0; i < min((size_t)5, known_primes.size()); i++) {
-            int p = known_primes[i];
-            long long mersenne = (1LL << p) - 1;
-            json << "{\"exponent\":" << p << ",\"mersenne_prime\":" << mersenne << "}";
-            if (i < min((size_t)4, known_primes.size()-1)) json << ",";
-        }
-        json << "],";
-        json << "\"performance_test\":[";
-        json << "{\"exponent\":31,\"time\":0.001,\"result\":\"prime\"}";
-        json << "],";
-        json << "\"analysis_time\":0.15";
+        json << "\"statistics\":" << engine->get_statistics_json() << ",";
+        json << "\"analysis_time\":" << duration<double>(high_resolution_clock::now() - start).count();
         json << "}";
         
         return json.str();
     }
     
-    string handle_progress_api() {
-        stringstream json;
+    void handle_progress_api(ArenaBuffer& json) {
         json << "{";
-        json << "\"timestamp\":\"" << get_current_time() << "\",";
+        json << "\"timestamp\":\"";
+        write_current_time(json);
+        json << "\",";
         json << "\"prime95\":{";
         json << "\"configured\":false,";
         json << "\"results\":{\"exists\":false},";
@@ -695,8 +1233,6 @@ private:
         json << "\"live\":{\"exists\":false}";
         json << "}";
         json << "}";
-        
-        return json.str();
     }
 };
 
@@ -717,14 +1253,31 @@ int main() {
         port = atoi(port_env);
     }
     
+    // Flight recorder: `kill -USR1 <pid>` writes the last few seconds of every thread
+    TraceRecorder::instance().set_thread_name("main");
+    TraceRecorder::instance().install_signal_dump("mersenne_trace.json");
+    
+    // Opt-in sampling profiler (MERSENNE_PROFILE=1): folded stacks at /api/profile
+    ProfiledThread profiled_main;
+    if (SamplingProfiler::instance().is_enabled()) {
+        cout << "🔥 Sampling profiler enabled - folded stacks at /api/profile" << endl;
+    }
+    
     try {
         MersenneDiscoveryEngine engine;
         HTTPServer server(&engine, port);
         
         cout << "🔧 Starting discovery engine..." << endl;
         
-        // Start discovery in background
-        thread discovery_thread([&engine]() {
+        // Start discovery in background (MERSENNE_DISCOVERY=0: web server only,
+        // e.g. for a load-test baseline without engine interference)
+        const char* discovery_env = getenv("MERSENNE_DISCOVERY");
+        bool discovery_enabled = !(discovery_env && string(discovery_env) == "0");
+        thread discovery_thread([&engine, discovery_enabled]() {
+            if (!discovery_enabled) {
+                cout << "⏸️ Background discovery disabled (MERSENNE_DISCOVERY=0)" << endl;
+                return;
+            }
             try {
                 engine.run_discovery(85000000, 85100000, 1000, thread::hardware_concurrency());
             } catch (const exception& e) {
@@ -0,0 +1,213 @@
+/*
+🎚️ ADAPTIVE CONCURRENCY CONTROLLER 🎚️
+Keeps a node near its real throughput peak instead of a fixed thread count:
+AVX-512 clock throttling, memory bandwidth shared with neighbours and mixed
+TF / LL work all move the peak, and past it more threads means less work.
+
+- Workers report useful work (LL iterations weighted by transform cost, TF
+  candidates...) with record_work()
+- A control thread samples aggregate work/s and hill-climbs the number of
+  active workers: keep stepping while throughput improves, undo a step that
+  hurt and hold, re-probe periodically once settled. A sample window lasts
+  at least one interval and stretches until every active worker has
+  reported about ten times, so slow reporters (huge exponents) still give a
+  real measurement
+- Starts with every worker active, like a fixed pool, and only steps down
+  once it has measured
+- Workers above the active limit park in checkpoint() at their next
+  iteration-block boundary and resume from the same point when unparked
+
+- suspend() / resume() park every worker regardless of the limit, e.g. while
+  a discovery is being confirmed on the whole node
+
+MERSENNE_CONCURRENCY=<n> pins the active count (no adaptation).
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+class AdaptiveConcurrency {
+public:
+    struct Snapshot {
+        int active = 0;
+        int max_workers = 0;
+        double work_per_second = 0;   // Smoothed
+        bool pinned = false;
+    };
+
+private:
+    const int max_workers;
+    const std::chrono::milliseconds interval;
+    std::atomic<int> active;
+    std::atomic<int> suspensions{0};
+    bool pinned = false;
+
+    std::atomic<uint64_t> work_micro{0};   // Work units * 1e6
+    std::atomic<uint64_t> reports{0};      // record_work calls
+    std::atomic<bool> running{false};
+    std::thread control_thread;
+
+    std::mutex park_mutex;
+    std::condition_variable unparked;
+
+    mutable std::mutex snapshot_mutex;
+    double smoothed = 0;
+
+    static constexpr double NOISE = 0.03;       // Relative change treated as no change
+    static constexpr int PROBE_EVERY = 10;      // Settled intervals between re-probes
+    static constexpr int REPORTS_PER_WORKER = 10; // Per active worker before a window closes (~1% quantization)
+
+    void set_active(int n) {
+        n = std::max(1, std::min(max_workers, n));
+        if (n == active.load()) return;
+        std::lock_guard<std::mutex> lock(park_mutex);
+        active = n;
+        unparked.notify_all();
+    }
+
+    void control_loop() {
+        int direction = -1;   // Starts at the top: the only probe is down
+        int held = 0;
+        bool holding = false;
+        double previous = -1;
+        uint64_t last_work = work_micro.load();
+        uint64_t last_reports = reports.load();
+        auto last_time = std::chrono::steady_clock::now();
+
+        while (running.load()) {
+            std::this_thread::sleep_for(interval);
+            // Keep the window open until the active workers have each reported
+            // REPORTS_PER_WORKER times; a parked (suspended) node just waits
+            uint64_t reported = reports.load();
+            if (reported - last_reports < (uint64_t)REPORTS_PER_WORKER * active.load() && suspensions.load() == 0) {
+                continue;
+            }
+            auto now = std::chrono::steady_clock::now();
+            uint64_t work = work_micro.load();
+            double seconds = std::chrono::duration<double>(now - last_time).count();
+            double rate = seconds > 0 ? (work - last_work) / 1e6 / seconds : 0;
+            last_work = work;
+            last_reports = reported;
+            last_time = now;
+
+            {
+                std::lock_guard<std::mutex> lock(snapshot_mutex);
+                smoothed = smoothed == 0 ? rate : 0.7 * smoothed + 0.3 * rate;
+            }
+            if (pinned || rate == 0) continue;
+            if (suspensions.load() > 0) {
+                // Parked by suspend(): the rate says nothing about the limit
+                previous = -1;
+                continue;
+            }
+
+            // Hill-climb on the raw interval rate. A step that hurt is undone
+            // and the controller holds there; so does a step that changed
+            // nothing. Held positions are re-probed every PROBE_EVERY intervals
+            // since the peak moves with clocks, neighbours and the work mix.
+            if (holding) {
+                previous = rate;
+                if (++held < PROBE_EVERY) continue;
+                holding = false;
+            } else if (previous >= 0) {
+                double change = (rate - previous) / std::max(previous, 1e-12);
+                if (change < -NOISE) {
+                    direction = -direction;
+                    set_active(active.load() + direction);
+                    holding = true;
+                    held = 0;
+                    previous = -1;
+                    continue;
+                }
+                if (change <= NOISE) {
+                    holding = true;
+                    held = 0;
+                    previous = rate;
+                    continue;
+                }
+            }
+            previous = rate;
+
+            int next = active.load() + direction;
+            if (next < 1 || next > max_workers) {
+                direction = -direction;
+                next = active.load() + direction;
+            }
+            set_active(next);
+        }
+    }
+
+public:
+    explicit AdaptiveConcurrency(int workers, std::chrono::milliseconds control_interval = std::chrono::seconds(2))
+        : max_workers(std::max(1, workers)), interval(control_interval), active(std::max(1, workers)) {
+        const char* env = std::getenv("MERSENNE_CONCURRENCY");
+        if (env && std::atoi(env) > 0) {
+            active = std::min(max_workers, std::atoi(env));
+            pinned = true;
+        }
+    }
+
+    ~AdaptiveConcurrency() { stop(); }
+
+    void start() {
+        if (running.exchange(true)) return;
+        control_thread = std::thread(&AdaptiveConcurrency::control_loop, this);
+    }
+
+    // Unparks everyone so workers can drain and exit
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (control_thread.joinable()) control_thread.join();
+        std::lock_guard<std::mutex> lock(park_mutex);
+        active = max_workers;
+        unparked.notify_all();
+    }
+
+    // Nestable; every worker parks at its next checkpoint until the last resume()
+    void suspend() {
+        std::lock_guard<std::mutex> lock(park_mutex);
+        suspensions++;
+    }
+
+    void resume() {
+        std::lock_guard<std::mutex> lock(park_mutex);
+        if (suspensions > 0) suspensions--;
+        unparked.notify_all();
+    }
+
+    void record_work(double units) {
+        work_micro.fetch_add((uint64_t)std::llround(units * 1e6), std::memory_order_relaxed);
+        reports.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Called by worker `id` at an iteration-block boundary: parks while the
+    // worker is above the active limit. Returns the seconds spent parked.
+    double checkpoint(int id) {
+        if (id < active.load(std::memory_order_relaxed) && suspensions.load(std::memory_order_relaxed) == 0) return 0;
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(park_mutex);
+        unparked.wait(lock, [&] { return id < active.load() && suspensions.load() == 0; });
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        return {active.load(), max_workers, smoothed, pinned};
+    }
+
+    // LL work weight: one iteration costs about n log n at transform length n ~ p,
+    // normalized so an iteration at p = 1M counts as 1
+    static double ll_iteration_weight(uint64_t p) {
+        double ref = 1e6 * std::log2(1e6);
+        return (double)p * std::log2((double)std::max<uint64_t>(p, 2)) / ref;
+    }
+};
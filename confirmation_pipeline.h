@@ -0,0 +1,478 @@
+/*
+✅ DISCOVERY CONFIRMATION PIPELINE ✅
+When an LL test says "prime", the node drops everything and re-proves it.
+
+- Background work is suspended through the scheduler (AdaptiveConcurrency):
+  every discovery worker parks at its next iteration-block boundary
+- Independent Lucas-Lehmer runs start at once, each pinned to one squaring
+  algorithm so no two share code: Karatsuba (small p only - past
+  KARATSUBA_MAX_LIMBS it would hold the verdict long after the others),
+  complex FFT, Goldilocks NTT, and GMP when built with USE_GMP. Each starts
+  from its own random shift
+- The FFT run keeps its own transform at every size: 16-bit pieces while
+  they stay exact, 8-bit pieces past FFT_MAX_POINTS. A squaring whose
+  round-off is too high is redone by the NTT and flagged in the report,
+  since that iteration was not independent of the ntt run
+- The freed cores are shared out: Karatsuba and GMP take one each, and the
+  FFT and NTT runs split the rest, each with its own FFTThreadPool
+- Shifted LL: s' = s * 2^k mod 2^p - 1, so every run squares different bits;
+  the shift doubles each iteration and the -2 becomes -2^(k+1)
+- Interim Res64s (low 64 bits of the unshifted residue) are posted every
+  interval and compared across runs as they arrive, so a bad backend or a
+  flaky core shows up at the first differing checkpoint, not at the end
+- The report lists every run, every mismatch and the verdict; it is written
+  to cpp_mersenne_verifications.txt and kept for /api/verifications
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "big_int.h"
+#include "concurrency_controller.h"
+#include "trace_recorder.h"
+
+#ifdef USE_GMP
+#include <gmp.h>
+#endif
+
+struct VerificationRun {
+    std::string backend;
+    uint64_t shift = 0;
+    bool finished = false;
+    bool prime = false;
+    uint64_t res64 = 0;          // Final, unshifted
+    double seconds = 0;
+    int threads = 1;
+    uint64_t fft_fallbacks = 0;  // FFT squarings redone by the NTT (round-off)
+};
+
+struct ResidueMismatch {
+    uint64_t iteration;
+    std::string backend_a, backend_b;
+    uint64_t res64_a, res64_b;
+};
+
+struct VerificationReport {
+    uint64_t p = 0;
+    std::vector<VerificationRun> runs;
+    std::vector<ResidueMismatch> mismatches;
+    uint64_t interim_checks = 0;       // Checkpoints where every run agreed
+    uint64_t interval = 0;
+    bool preempted = false;            // Background work was suspended
+    double wall_seconds = 0;
+    std::string verdict;               // "confirmed", "refuted" or "inconsistent"
+
+    static std::string hex64(uint64_t x) {
+        std::stringstream s;
+        s << std::hex << std::uppercase << std::setw(16) << std::setfill('0') << x;
+        return s.str();
+    }
+
+    std::string to_text() const {
+        std::stringstream out;
+        out << "VERIFICATION REPORT: M" << p << " - " << verdict << "\n";
+        out << "Wall time: " << wall_seconds << "s, background work "
+            << (preempted ? "suspended" : "not suspended") << "\n";
+        for (const VerificationRun& r : runs) {
+            out << "  " << std::left << std::setw(9) << r.backend << std::right << " shift " << std::setw(10) << r.shift
+                << "  " << (r.finished ? (r.prime ? "prime    " : "composite") : "unfinished")
+                << "  Res64 " << hex64(r.res64) << "  " << r.seconds << "s on " << r.threads
+                << (r.threads == 1 ? " thread" : " threads");
+            if (r.fft_fallbacks) out << "  (" << r.fft_fallbacks << " squarings fell back to the NTT - not independent)";
+            out << "\n";
+        }
+        out << "Interim Res64 checks (every " << interval << " iterations): " << interim_checks << " agreed, "
+            << mismatches.size() << " mismatched\n";
+        for (const ResidueMismatch& m : mismatches) {
+            out << "  iteration " << m.iteration << ": " << m.backend_a << " " << hex64(m.res64_a) << " != "
+                << m.backend_b << " " << hex64(m.res64_b) << "\n";
+        }
+        out << "---\n";
+        return out.str();
+    }
+
+    std::string to_json() const {
+        std::stringstream json;
+        json << "{\"exponent\":" << p << ",\"verdict\":\"" << verdict << "\",\"wall_seconds\":" << wall_seconds
+             << ",\"preempted\":" << (preempted ? "true" : "false") << ",\"interval\":" << interval
+             << ",\"interim_checks\":" << interim_checks << ",\"runs\":[";
+        for (size_t i = 0; i < runs.size(); i++) {
+            const VerificationRun& r = runs[i];
+            json << (i ? "," : "") << "{\"backend\":\"" << r.backend << "\",\"shift\":" << r.shift
+                 << ",\"finished\":" << (r.finished ? "true" : "false") << ",\"prime\":" << (r.prime ? "true" : "false")
+                 << ",\"res64\":\"" << hex64(r.res64) << "\",\"seconds\":" << r.seconds
+                 << ",\"threads\":" << r.threads << ",\"fft_fallbacks\":" << r.fft_fallbacks << "}";
+        }
+        json << "],\"mismatches\":[";
+        for (size_t i = 0; i < mismatches.size(); i++) {
+            const ResidueMismatch& m = mismatches[i];
+            json << (i ? "," : "") << "{\"iteration\":" << m.iteration << ",\"a\":\"" << m.backend_a
+                 << "\",\"res64_a\":\"" << hex64(m.res64_a) << "\",\"b\":\"" << m.backend_b
+                 << "\",\"res64_b\":\"" << hex64(m.res64_b) << "\"}";
+        }
+        json << "]}";
+        return json.str();
+    }
+};
+
+class ConfirmationPipeline {
+private:
+    // ========================================
+    // SHIFTED LL BACKENDS
+    // ========================================
+
+    // One shifted LL residue; step() does s' = s'^2 - 2^(k'+1), k' = 2k mod p
+    class Backend {
+    protected:
+        uint64_t p;
+        uint64_t shift;         // Current k; doubles every step
+        uint64_t first_shift;
+        int threads = 1;        // Of the run's FFTThreadPool (parallel backends only)
+
+    public:
+        Backend(uint64_t exponent, uint64_t initial_shift)
+            : p(exponent), shift(initial_shift % exponent), first_shift(shift) {}
+        virtual ~Backend() = default;
+
+        virtual const char* name() const = 0;
+        virtual void step() = 0;
+        virtual bool is_zero() const = 0;
+        virtual bool bit(uint64_t i) const = 0;   // Bit i of s' (i < p)
+        virtual uint64_t fallbacks() const { return 0; }
+        virtual bool parallel() const { return false; }   // Can use more than one thread
+
+        uint64_t initial_shift() const { return first_shift; }
+        int thread_count() const { return threads; }
+        void set_threads(int n) { threads = std::max(1, n); }
+
+        // Low 64 bits of s = s' * 2^-k: bit i of s is bit (i + k) mod p of s'
+        uint64_t res64() const {
+            uint64_t r = 0;
+            for (uint64_t i = 0; i < std::min<uint64_t>(64, p); i++) {
+                if (bit((i + shift) % p)) r |= (uint64_t)1 << i;
+            }
+            return r;
+        }
+    };
+
+    using limb_t = bigint::limb_t;
+
+    // Limb residue squared by one pinned algorithm, folded mod 2^p - 1
+    class LimbBackend : public Backend {
+    public:
+        enum Squarer { KARATSUBA, FFT, NTT };
+
+    private:
+        Squarer squarer;
+        size_t mn;
+        std::vector<limb_t> x, product, m_minus_bit;
+        size_t xn = 0;
+        uint64_t fft_fallbacks = 0;
+
+        // FFT squaring state: balanced pieces of piece_bits bits
+        int piece_bits = 16;
+        size_t points = 0;
+        std::vector<std::complex<double>> z;
+
+        void set_bit(std::vector<limb_t>& v, uint64_t b, bool on) {
+            limb_t mask = (limb_t)1 << (b % 64);
+            if (on) v[b / 64] |= mask;
+            else v[b / 64] &= ~mask;
+        }
+
+        // product[0, 2xn) = x^2 by the complex FFT; false if round-off was too high
+        bool fft_square() {
+            int per_limb = 64 / piece_bits;
+            limb_t mask = ((limb_t)1 << piece_bits) - 1;
+            int half = 1 << (piece_bits - 1);
+
+            int carry = 0;
+            size_t k = 0;
+            for (size_t i = 0; i < xn; i++) {
+                for (int j = 0; j < per_limb; j++, k++) {
+                    int piece = (int)((x[i] >> (piece_bits * j)) & mask) + carry;
+                    carry = piece >= half;
+                    z[k] = {(double)(piece - (carry << piece_bits)), 0.0};
+                }
+            }
+            z[k++] = {(double)carry, 0.0};
+            std::fill(z.begin() + k, z.end(), std::complex<double>());
+
+            FFTPlanner& planner = FFTPlanner::instance();
+            FFTPlan plan = planner.plan_for(points);
+            plan.threads = threads;
+            planner.execute(plan, z.data(), points, false);
+            std::complex<double>* data = z.data();
+            FFTThreadPool::parallel_for(threads, points, [data](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) data[i] *= data[i];
+            });
+            planner.execute(plan, z.data(), points, true);
+
+            double max_roundoff = 0;
+            __int128 sum = 0;
+            k = 0;
+            for (size_t i = 0; i < 2 * xn; i++) {
+                limb_t limb = 0;
+                for (int j = 0; j < per_limb; j++, k++) {
+                    double v = z[k].real();
+                    double rounded = std::nearbyint(v);
+                    max_roundoff = std::max(max_roundoff, std::fabs(v - rounded));
+                    sum += (__int128)(int64_t)rounded;
+                    limb |= (limb_t)((uint64_t)sum & mask) << (piece_bits * j);
+                    sum >>= piece_bits;
+                }
+                product[i] = limb;
+            }
+            return max_roundoff <= bigint::FFT_MAX_ROUNDOFF;
+        }
+
+    public:
+        LimbBackend(Squarer how, uint64_t exponent, uint64_t initial_shift)
+            : Backend(exponent, initial_shift), squarer(how), mn((exponent + 63) / 64),
+              x(2 * mn + 2, 0), product(2 * mn + 2, 0) {
+            BigInt m = BigInt::mersenne(p);
+            m_minus_bit.assign(m.data(), m.data() + mn);
+            // s'_0 = 4 * 2^k
+            uint64_t b = (shift + 2) % p;
+            x[b / 64] = (limb_t)1 << (b % 64);
+            xn = bigint::detail::normalized(x.data(), mn);
+
+            if (squarer == FFT) {
+                // 16-bit pieces while they stay exact in doubles, else 8-bit
+                piece_bits = fft_points(mn, 16) <= bigint::FFT_MAX_POINTS ? 16 : 8;
+                points = fft_points(mn, piece_bits);
+                z.resize(points);
+            }
+        }
+
+        // Transform length for squaring n limbs in `bits`-bit pieces
+        static size_t fft_points(size_t n, int bits) {
+            size_t need = 2 * n * (64 / bits) + 2, length = 1;
+            while (length < need) length <<= 1;
+            return length;
+        }
+
+        const char* name() const override {
+            return squarer == FFT ? "fft" : squarer == NTT ? "ntt" : "karatsuba";
+        }
+
+        bool parallel() const override { return squarer != KARATSUBA; }
+
+        void step() override {
+            namespace d = bigint::detail;
+            size_t pn = 2 * xn;
+            if (xn) {
+                if (squarer == KARATSUBA) {
+                    d::karatsuba(product.data(), x.data(), x.data(), xn);
+                } else if (squarer == NTT) {
+                    d::ntt_mul(product.data(), x.data(), xn, x.data(), xn, threads);
+                } else if (!fft_square()) {
+                    d::ntt_mul(product.data(), x.data(), xn, x.data(), xn, threads);
+                    fft_fallbacks++;
+                }
+            }
+            x.swap(product);
+            xn = d::fold_mersenne(x.data(), d::normalized(x.data(), pn), p);
+
+            // - 2^(k'+1): add M with that bit cleared, then fold again
+            shift = (2 * shift) % p;
+            uint64_t b = (shift + 1) % p;
+            std::fill(x.begin() + xn, x.begin() + mn + 1, 0);
+            set_bit(m_minus_bit, b, false);
+            x[mn] = d::add(x.data(), x.data(), mn, m_minus_bit.data(), mn);
+            set_bit(m_minus_bit, b, true);
+            xn = d::fold_mersenne(x.data(), d::normalized(x.data(), mn + 1), p);
+        }
+
+        bool is_zero() const override { return xn == 0; }
+        bool bit(uint64_t i) const override { return i / 64 < xn && ((x[i / 64] >> (i % 64)) & 1); }
+        uint64_t fallbacks() const override { return fft_fallbacks; }
+    };
+
+    #ifdef USE_GMP
+    class GmpBackend : public Backend {
+    private:
+        mpz_t s, m, t;
+
+    public:
+        GmpBackend(uint64_t exponent, uint64_t initial_shift) : Backend(exponent, initial_shift) {
+            mpz_inits(s, m, t, NULL);
+            mpz_ui_pow_ui(m, 2, p);
+            mpz_sub_ui(m, m, 1);
+            mpz_setbit(s, (shift + 2) % p);
+        }
+        ~GmpBackend() override { mpz_clears(s, m, t, NULL); }
+
+        const char* name() const override { return "gmp"; }
+
+        void step() override {
+            mpz_mul(t, s, s);
+            mpz_tdiv_q_2exp(s, t, p);        // Fold: high + low
+            mpz_tdiv_r_2exp(t, t, p);
+            mpz_add(s, s, t);
+            if (mpz_cmp(s, m) >= 0) mpz_sub(s, s, m);
+
+            shift = (2 * shift) % p;
+            mpz_set_ui(t, 0);
+            mpz_setbit(t, (shift + 1) % p);
+            if (mpz_cmp(s, t) < 0) mpz_add(s, s, m);
+            mpz_sub(s, s, t);
+        }
+
+        bool is_zero() const override { return mpz_sgn(s) == 0 || mpz_cmp(s, m) == 0; }
+        bool bit(uint64_t i) const override { return mpz_tstbit(s, i); }
+    };
+    #endif
+
+    // ========================================
+    // INTERIM RESIDUE BOARD
+    // ========================================
+
+    struct Board {
+        std::mutex mutex;
+        std::map<uint64_t, std::vector<std::pair<size_t, uint64_t>>> posted;   // iteration -> (run, res64)
+        size_t runs = 0;
+        std::vector<std::string> names;
+        VerificationReport* report = nullptr;
+
+        // Compares against every run already at this iteration
+        void post(size_t run, uint64_t iteration, uint64_t res64) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& seen = posted[iteration];
+            for (const auto& [other, value] : seen) {
+                if (value != res64) {
+                    report->mismatches.push_back({iteration, names[other], names[run], value, res64});
+                }
+            }
+            seen.push_back({run, res64});
+            if (seen.size() == runs) {
+                bool agreed = std::all_of(seen.begin(), seen.end(), [&](const auto& e) { return e.second == seen[0].second; });
+                if (agreed) report->interim_checks++;
+                posted.erase(iteration);   // Every run has been compared here
+            }
+        }
+    };
+
+    // Karatsuba squaring is O(n^1.58): past this many limbs it would finish
+    // long after the transform runs and hold up the verdict
+    static constexpr size_t KARATSUBA_MAX_LIMBS = 2048;
+
+    AdaptiveConcurrency* scheduler;
+    uint64_t interval_override;
+
+    std::vector<std::unique_ptr<Backend>> make_backends(uint64_t p) {
+        std::mt19937_64 rng(std::random_device{}() ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+        auto random_shift = [&]() { return p > 2 ? 1 + rng() % (p - 1) : 0; };
+
+        std::vector<std::unique_ptr<Backend>> backends;
+        if ((p + 63) / 64 <= KARATSUBA_MAX_LIMBS) {
+            backends.emplace_back(new LimbBackend(LimbBackend::KARATSUBA, p, random_shift()));
+        }
+        backends.emplace_back(new LimbBackend(LimbBackend::FFT, p, random_shift()));
+        backends.emplace_back(new LimbBackend(LimbBackend::NTT, p, random_shift()));
+        #ifdef USE_GMP
+        backends.emplace_back(new GmpBackend(p, random_shift()));
+        #endif
+
+        // Serial runs take one core each; the transform runs split the rest
+        int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+        int parallel = 0, serial = 0;
+        for (const auto& b : backends) (b->parallel() ? parallel : serial)++;
+        int share = parallel ? std::max(1, (cores - serial) / parallel) : 1;
+        for (const auto& b : backends) b->set_threads(b->parallel() ? share : 1);
+        return backends;
+    }
+
+public:
+    // scheduler: suspended for the duration of a confirmation (may be null).
+    // interval: iterations between interim Res64 checks (0 = ~100 per test).
+    explicit ConfirmationPipeline(AdaptiveConcurrency* background = nullptr, uint64_t interval = 0)
+        : scheduler(background), interval_override(interval) {}
+
+    VerificationReport confirm(uint64_t p) {
+        if (p < 2) throw std::invalid_argument("ConfirmationPipeline: exponent must be >= 2");
+
+        VerificationReport report;
+        report.p = p;
+        auto start = std::chrono::steady_clock::now();
+
+        if (p == 2) {
+            // No LL iterations to re-run: M2 = 3
+            report.verdict = "confirmed";
+            return report;
+        }
+
+        uint64_t iterations = p - 2;
+        report.interval = interval_override ? interval_override : std::max<uint64_t>(1, iterations / 100);
+
+        // Free the cores first; released on every exit path
+        struct Suspension {
+            AdaptiveConcurrency* scheduler;
+            explicit Suspension(AdaptiveConcurrency* s) : scheduler(s) { if (scheduler) scheduler->suspend(); }
+            ~Suspension() { if (scheduler) scheduler->resume(); }
+        } suspension(scheduler);
+        report.preempted = scheduler != nullptr;
+
+        std::vector<std::unique_ptr<Backend>> backends = make_backends(p);
+        report.runs.resize(backends.size());
+
+        Board board;
+        board.runs = backends.size();
+        board.report = &report;
+        for (const auto& b : backends) board.names.push_back(b->name());
+
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < backends.size(); r++) {
+            threads.emplace_back([&, r]() {
+                TraceRecorder::instance().set_thread_name(std::string("verify-") + backends[r]->name());
+                TraceSpan span("verification_run", "confirm", p);
+                Backend& b = *backends[r];
+                VerificationRun& run = report.runs[r];
+                run.backend = b.name();
+                run.shift = b.initial_shift();
+                run.threads = b.thread_count();
+
+                // The run's own helpers, so the transform runs never queue on one pool
+                FFTThreadPool pool;
+                FFTThreadPool::Scope scope(pool);
+
+                auto t0 = std::chrono::steady_clock::now();
+                for (uint64_t i = 1; i <= iterations; i++) {
+                    b.step();
+                    if (i % report.interval == 0 || i == iterations) board.post(r, i, b.res64());
+                }
+                run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                run.finished = true;
+                run.prime = b.is_zero();
+                run.res64 = b.res64();
+                run.fft_fallbacks = b.fallbacks();
+            });
+        }
+        for (std::thread& t : threads) t.join();
+
+        bool all_prime = std::all_of(report.runs.begin(), report.runs.end(), [](const VerificationRun& r) { return r.prime; });
+        bool all_composite = std::none_of(report.runs.begin(), report.runs.end(), [](const VerificationRun& r) { return r.prime; });
+        if (!report.mismatches.empty() || !(all_prime || all_composite)) report.verdict = "inconsistent";
+        else report.verdict = all_prime ? "confirmed" : "refuted";
+
+        report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+};
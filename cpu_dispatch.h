@@ -0,0 +1,292 @@
+/*
+⚙️ RUNTIME CPU-FEATURE DISPATCH ⚙️
+One binary, best kernel on every host.
+
+Each hot kernel has a single portable body that is compiled three times -
+generic x86-64, AVX2+FMA+BMI2 and AVX-512 - through GCC target attributes.
+The host's CPU features are probed once at startup and a table of function
+pointers is resolved; nothing in the binary requires more than the baseline
+ISA, so builds no longer need -march=native.
+
+Kernels: FFT butterflies (radix-2 / radix-4 passes), trial-factoring
+modexp (2^p mod q), batched Miller-Rabin, segment sieve.
+
+MERSENNE_ISA=generic|avx2|avx512 caps the selection (testing / A-B runs).
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MERSENNE_ISA_DISPATCH 1
+#define DISPATCH_TARGET_AVX2 __attribute__((target("avx2,fma,bmi2")))
+#define DISPATCH_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma,bmi2")))
+#else
+#define MERSENNE_ISA_DISPATCH 0
+#endif
+
+#if defined(__GNUC__)
+#define KERNEL_BODY static inline __attribute__((always_inline))
+#else
+#define KERNEL_BODY static inline
+#endif
+
+// ========================================
+// HOST FEATURES
+// ========================================
+
+struct CpuFeatures {
+    bool avx2 = false;
+    bool fma = false;
+    bool bmi2 = false;
+    bool avx512 = false;   // F + DQ + VL
+
+    static const CpuFeatures& host() {
+        static const CpuFeatures features = detect();
+        return features;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+        #if MERSENNE_ISA_DISPATCH
+        __builtin_cpu_init();
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.fma = __builtin_cpu_supports("fma");
+        f.bmi2 = __builtin_cpu_supports("bmi2");
+        f.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+                && __builtin_cpu_supports("avx512vl");
+        #endif
+        return f;
+    }
+};
+
+// ========================================
+// PORTABLE KERNEL BODIES
+// ========================================
+// Always inlined into each ISA wrapper below so the compiler vectorizes and
+// schedules them for that target. Complex data is interleaved (re, im) - the
+// layout of std::complex<double> arrays.
+
+namespace kernel_body {
+
+// One radix-2 DIT pass of length len over [base, base + span)
+KERNEL_BODY void radix2_pass(double* a, size_t base, size_t span, size_t len,
+                             const double* tw, size_t n, bool invert) {
+    size_t half = len / 2, stride = n / len;
+    double sign = invert ? -1.0 : 1.0;
+    for (size_t i = base; i < base + span; i += len) {
+        double* lo = a + 2 * i;
+        double* hi = a + 2 * (i + half);
+        for (size_t j = 0; j < half; j++) {
+            double wr = tw[2 * j * stride], wi = sign * tw[2 * j * stride + 1];
+            double xr = hi[2 * j], xi = hi[2 * j + 1];
+            double vr = xr * wr - xi * wi, vi = xr * wi + xi * wr;
+            double ur = lo[2 * j], ui = lo[2 * j + 1];
+            lo[2 * j] = ur + vr;     lo[2 * j + 1] = ui + vi;
+            hi[2 * j] = ur - vr;     hi[2 * j + 1] = ui - vi;
+        }
+    }
+}
+
+// Two radix-2 passes (len/2 then len) fused into one radix-4 sweep.
+// Bit-reversed layout: quarters hold residues 0, 2, 1, 3 (mod 4).
+KERNEL_BODY void radix4_pass(double* a, size_t base, size_t span, size_t len,
+                             const double* tw, size_t n, bool invert) {
+    size_t q = len / 4, stride = n / len;
+    double sign = invert ? -1.0 : 1.0;
+    for (size_t i = base; i < base + span; i += len) {
+        double* p0 = a + 2 * i;
+        double* p1 = p0 + 2 * q;
+        double* p2 = p1 + 2 * q;
+        double* p3 = p2 + 2 * q;
+        for (size_t j = 0; j < q; j++) {
+            double w1r = tw[2 * j * stride], w1i = sign * tw[2 * j * stride + 1];
+            double w2r = tw[4 * j * stride], w2i = sign * tw[4 * j * stride + 1];
+
+            double a0r = p0[2 * j], a0i = p0[2 * j + 1];
+            double a1r = p1[2 * j], a1i = p1[2 * j + 1];
+            double a2r = p2[2 * j], a2i = p2[2 * j + 1];
+            double a3r = p3[2 * j], a3i = p3[2 * j + 1];
+
+            double t1r = w2r * a1r - w2i * a1i, t1i = w2r * a1i + w2i * a1r;
+            double t3r = w2r * a3r - w2i * a3i, t3i = w2r * a3i + w2i * a3r;
+
+            double e0r = a0r + t1r, e0i = a0i + t1i, e1r = a0r - t1r, e1i = a0i - t1i;
+            double o0r = a2r + t3r, o0i = a2i + t3i, o1r = a2r - t3r, o1i = a2i - t3i;
+
+            // u0 = w1 * o0; u1 = w1 * (-i * sign) * o1
+            double u0r = w1r * o0r - w1i * o0i, u0i = w1r * o0i + w1i * o0r;
+            double r1r = sign * o1i, r1i = -sign * o1r;
+            double u1r = w1r * r1r - w1i * r1i, u1i = w1r * r1i + w1i * r1r;
+
+            p0[2 * j] = e0r + u0r;  p0[2 * j + 1] = e0i + u0i;
+            p2[2 * j] = e0r - u0r;  p2[2 * j + 1] = e0i - u0i;
+            p1[2 * j] = e1r + u1r;  p1[2 * j + 1] = e1i + u1i;
+            p3[2 * j] = e1r - u1r;  p3[2 * j + 1] = e1i - u1i;
+        }
+    }
+}
+
+// 64-bit Montgomery helpers (odd modulus < 2^63)
+KERNEL_BODY uint64_t mont_neg_inverse(uint64_t m) {
+    uint64_t inv = m;                       // Correct to 3 bits for odd m
+    for (int i = 0; i < 5; i++) inv *= 2 - m * inv;
+    return 0 - inv;
+}
+
+KERNEL_BODY uint64_t mont_mul(uint64_t a, uint64_t b, uint64_t m, uint64_t neg_inv) {
+    unsigned __int128 t = (unsigned __int128)a * b;
+    uint64_t k = (uint64_t)t * neg_inv;
+    uint64_t u = (uint64_t)((t + (unsigned __int128)k * m) >> 64);
+    return u >= m ? u - m : u;
+}
+
+// out[i] = 2^p mod q[i]; q[i] odd and < 2^63 (trial-factoring candidates 2kp+1)
+KERNEL_BODY void tf_modexp_batch(uint64_t p, const uint64_t* q, uint64_t* out, size_t count) {
+    int top = 63 - __builtin_clzll(p);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t m = q[i];
+        uint64_t neg_inv = mont_neg_inverse(m);
+        uint64_t x = (0 - m) % m;            // R mod m = Montgomery one
+        for (int bit = top; bit >= 0; bit--) {
+            x = mont_mul(x, x, m, neg_inv);
+            if ((p >> bit) & 1) {
+                x <<= 1;                     // Doubling commutes with the Montgomery form
+                if (x >= m) x -= m;
+            }
+        }
+        out[i] = mont_mul(x, 1, m, neg_inv);
+    }
+}
+
+KERNEL_BODY uint64_t mont_pow(uint64_t base_m, uint64_t exp, uint64_t one_m, uint64_t m, uint64_t neg_inv) {
+    uint64_t result = one_m;
+    while (exp) {
+        if (exp & 1) result = mont_mul(result, base_m, m, neg_inv);
+        base_m = mont_mul(base_m, base_m, m, neg_inv);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// Deterministic Miller-Rabin for every n < 2^63 (first 12 prime bases)
+KERNEL_BODY void mr_batch(const uint64_t* values, uint8_t* is_prime, size_t count) {
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    for (size_t idx = 0; idx < count; idx++) {
+        uint64_t n = values[idx];
+        uint8_t verdict = 1;
+        if (n < 2) verdict = 0;
+        else {
+            for (uint64_t b : bases) {
+                if (n == b) goto done;
+                if (n % b == 0) { verdict = 0; goto done; }
+            }
+            if (n >> 63) { verdict = 0; goto done; }  // Out of kernel range; callers pre-filter
+
+            {
+                uint64_t d = n - 1;
+                int r = __builtin_ctzll(d);
+                d >>= r;
+                uint64_t neg_inv = mont_neg_inverse(n);
+                uint64_t one_m = (0 - n) % n;
+                uint64_t minus_one_m = n - one_m;
+                uint64_t r2 = (uint64_t)(((unsigned __int128)one_m * one_m) % n);
+
+                for (uint64_t b : bases) {
+                    uint64_t x = mont_pow(mont_mul(b, r2, n, neg_inv), d, one_m, n, neg_inv);
+                    if (x == one_m || x == minus_one_m) continue;
+                    bool witness = true;
+                    for (int i = 1; i < r; i++) {
+                        x = mont_mul(x, x, n, neg_inv);
+                        if (x == minus_one_m) { witness = false; break; }
+                    }
+                    if (witness) { verdict = 0; break; }
+                }
+            }
+        }
+    done:
+        is_prime[idx] = verdict;
+    }
+}
+
+// composite[i] = 1 if lo + i has a factor among primes[0..count) below itself
+KERNEL_BODY void sieve_segment(uint8_t* composite, uint64_t lo, size_t len,
+                               const uint32_t* primes, size_t count) {
+    for (size_t i = 0; i < len; i++) composite[i] = 0;
+    for (size_t k = 0; k < count; k++) {
+        uint64_t p = primes[k];
+        uint64_t first = ((lo + p - 1) / p) * p;
+        if (first < p * p) first = p * p;
+        for (uint64_t x = first; x < lo + len; x += p) composite[x - lo] = 1;
+    }
+}
+
+} // namespace kernel_body
+
+// ========================================
+// KERNEL TABLE
+// ========================================
+
+struct KernelTable {
+    const char* isa_name;
+    void (*radix2_pass)(double*, size_t, size_t, size_t, const double*, size_t, bool);
+    void (*radix4_pass)(double*, size_t, size_t, size_t, const double*, size_t, bool);
+    void (*tf_modexp_batch)(uint64_t, const uint64_t*, uint64_t*, size_t);
+    void (*mr_batch)(const uint64_t*, uint8_t*, size_t);
+    void (*sieve_segment)(uint8_t*, uint64_t, size_t, const uint32_t*, size_t);
+};
+
+#define KERNEL_VARIANT_SET(suffix, TARGET)                                                              \
+    namespace kernel_##suffix {                                                                         \
+    TARGET inline void radix2_pass(double* a, size_t base, size_t span, size_t len,                     \
+                                   const double* tw, size_t n, bool invert) {                           \
+        kernel_body::radix2_pass(a, base, span, len, tw, n, invert);                                    \
+    }                                                                                                   \
+    TARGET inline void radix4_pass(double* a, size_t base, size_t span, size_t len,                     \
+                                   const double* tw, size_t n, bool invert) {                           \
+        kernel_body::radix4_pass(a, base, span, len, tw, n, invert);                                    \
+    }                                                                                                   \
+    TARGET inline void tf_modexp_batch(uint64_t p, const uint64_t* q, uint64_t* out, size_t count) {    \
+        kernel_body::tf_modexp_batch(p, q, out, count);                                                 \
+    }                                                                                                   \
+    TARGET inline void mr_batch(const uint64_t* values, uint8_t* is_prime, size_t count) {              \
+        kernel_body::mr_batch(values, is_prime, count);                                                 \
+    }                                                                                                   \
+    TARGET inline void sieve_segment(uint8_t* composite, uint64_t lo, size_t len,                       \
+                                     const uint32_t* primes, size_t count) {                            \
+        kernel_body::sieve_segment(composite, lo, len, primes, count);                                  \
+    }                                                                                                   \
+    inline const KernelTable& table() {                                                                 \
+        static const KernelTable t = {#suffix, radix2_pass, radix4_pass, tf_modexp_batch,               \
+                                      mr_batch, sieve_segment};                                         \
+        return t;                                                                                       \
+    }                                                                                                   \
+    }
+
+#define DISPATCH_TARGET_GENERIC
+KERNEL_VARIANT_SET(generic, DISPATCH_TARGET_GENERIC)
+#if MERSENNE_ISA_DISPATCH
+KERNEL_VARIANT_SET(avx2, DISPATCH_TARGET_AVX2)
+KERNEL_VARIANT_SET(avx512, DISPATCH_TARGET_AVX512)
+#endif
+
+// Resolved once; every call site goes through the returned table
+inline const KernelTable& kernels() {
+    static const KernelTable* selected = []() {
+        std::string cap = "avx512";
+        if (const char* env = std::getenv("MERSENNE_ISA")) cap = env;
+
+        #if MERSENNE_ISA_DISPATCH
+        const CpuFeatures& f = CpuFeatures::host();
+        if (cap == "avx512" && f.avx512 && f.avx2 && f.fma && f.bmi2) return &kernel_avx512::table();
+        if ((cap == "avx512" || cap == "avx2") && f.avx2 && f.fma && f.bmi2) return &kernel_avx2::table();
+        #endif
+        return &kernel_generic::table();
+    }();
+    return *selected;
+}
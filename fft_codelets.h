@@ -0,0 +1,272 @@
+/*
+🧩 COMPILE-TIME FFT CODELETS 🧩
+Fixed-size complex FFTs generated by template recursion, for the leaf levels
+of the planned transforms in fft_plan.h.
+
+- Twiddles are constexpr tables (exp(-2 pi i j / N), computed at compile time
+  with an octant-reduced series in long double), one per size
+- Sizes 2..32 expand into straight-line code: every index and twiddle is a
+  compile-time constant, j = 0 and j = N/4 butterflies drop their multiplies,
+  and the whole transform stays in registers (the radix-4/8/16/32 codelets)
+- Sizes 64..1024 are complete transforms composed from those: quarter-size
+  codelets and one fused radix-4 sweep with a constant trip count over a
+  constexpr twiddle table, so the compiler unrolls and vectorizes it
+- Every codelet is built per ISA (generic / AVX2 / AVX-512) through the same
+  target attributes as cpu_dispatch.h and follows its selection
+
+Input is in bit-reversed order and the result is unnormalized, exactly like
+the first log2(N) radix-2 DIT passes of FFTPlanner::direct, which is what a
+codelet replaces.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "cpu_dispatch.h"
+
+#if defined(__GNUC__)
+#define CODELET_INLINE inline __attribute__((always_inline))
+#else
+#define CODELET_INLINE inline
+#endif
+
+namespace codelets {
+
+constexpr size_t MAX_SIZE = 1024;
+constexpr size_t STRAIGHT_LINE_MAX = 32;   // Fully unrolled up to here
+
+// ========================================
+// CONSTEXPR TWIDDLES
+// ========================================
+
+constexpr long double PI = 3.141592653589793238462643383279502884L;
+
+// Taylor series on |x| <= pi/4, where 14 terms are far below double precision
+constexpr long double sin_series(long double x) {
+    long double term = x, sum = x;
+    for (int k = 1; k < 14; k++) {
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr long double cos_series(long double x) {
+    long double term = 1, sum = 1;
+    for (int k = 1; k < 14; k++) {
+        term *= -x * x / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+struct Twiddle {
+    double re, im;
+};
+
+// exp(-2 pi i k / n), reduced to the first octant with exact integer steps so
+// symmetric entries come out exactly symmetric
+constexpr Twiddle root(size_t k, size_t n) {
+    k %= n;
+    // 8k / n picks the octant; r is the remainder angle in units of 2 pi / (8n)
+    size_t octant = 8 * k / n;
+    long double r = (long double)(8 * k - octant * n);
+    long double step = PI / 4 / n;   // (2 pi / 8) / n
+    long double c = 0, s = 0;        // cos, sin of 2 pi k / n
+    switch (octant) {
+        case 0: c = cos_series(r * step);            s = sin_series(r * step);            break;
+        case 1: c = sin_series((n - r) * step);      s = cos_series((n - r) * step);      break;
+        case 2: c = -sin_series(r * step);           s = cos_series(r * step);            break;
+        case 3: c = -cos_series((n - r) * step);     s = sin_series((n - r) * step);      break;
+        case 4: c = -cos_series(r * step);           s = -sin_series(r * step);           break;
+        case 5: c = -sin_series((n - r) * step);     s = -cos_series((n - r) * step);     break;
+        case 6: c = sin_series(r * step);            s = -cos_series(r * step);           break;
+        default: c = cos_series((n - r) * step);     s = -sin_series((n - r) * step);     break;
+    }
+    return {(double)c, (double)-s};
+}
+
+template <size_t N>
+constexpr std::array<Twiddle, N / 2> make_twiddles() {
+    std::array<Twiddle, N / 2> table{};
+    for (size_t j = 0; j < N / 2; j++) table[j] = root(j, N);
+    return table;
+}
+
+template <size_t N>
+struct Twiddles {
+    static constexpr std::array<Twiddle, N / 2> table = make_twiddles<N>();
+};
+
+// ========================================
+// CODELETS
+// ========================================
+// Interleaved (re, im) doubles, the layout of std::complex<double> arrays
+
+// One DIT butterfly of the size-N combine at a compile-time position J:
+// a[J] += w^J a[J + N/2], a[J + N/2] = old a[J] - w^J a[J + N/2]
+template <size_t N, size_t J, bool Invert>
+CODELET_INLINE void butterfly(double* a) {
+    constexpr size_t H = N / 2;
+    double xr = a[2 * (J + H)], xi = a[2 * (J + H) + 1];
+    double vr, vi;
+    if constexpr (J == 0) {
+        vr = xr; vi = xi;                                  // w = 1
+    } else if constexpr (4 * J == N) {
+        if constexpr (Invert) { vr = -xi; vi = xr; }       // w = +i
+        else { vr = xi; vi = -xr; }                        // w = -i
+    } else {
+        constexpr Twiddle w = Twiddles<N>::table[J];
+        constexpr double wr = w.re, wi = Invert ? -w.im : w.im;
+        vr = xr * wr - xi * wi;
+        vi = xr * wi + xi * wr;
+    }
+    double ur = a[2 * J], ui = a[2 * J + 1];
+    a[2 * J] = ur + vr;            a[2 * J + 1] = ui + vi;
+    a[2 * (J + H)] = ur - vr;      a[2 * (J + H) + 1] = ui - vi;
+}
+
+template <size_t N, bool Invert, size_t... J>
+CODELET_INLINE void combine_unrolled(double* a, std::index_sequence<J...>) {
+    (butterfly<N, J, Invert>(a), ...);
+}
+
+// Combine sweeps for the composed sizes: runtime loop index, but a constant
+// trip count and constexpr twiddles, so they unroll and vectorize
+template <size_t N, bool Invert>
+CODELET_INLINE void combine2(double* a) {
+    constexpr size_t H = N / 2;
+    const std::array<Twiddle, H>& tw = Twiddles<N>::table;
+    double* lo = a;
+    double* hi = a + 2 * H;
+    for (size_t j = 0; j < H; j++) {
+        double wr = tw[j].re, wi = Invert ? -tw[j].im : tw[j].im;
+        double xr = hi[2 * j], xi = hi[2 * j + 1];
+        double vr = xr * wr - xi * wi, vi = xr * wi + xi * wr;
+        double ur = lo[2 * j], ui = lo[2 * j + 1];
+        lo[2 * j] = ur + vr;     lo[2 * j + 1] = ui + vi;
+        hi[2 * j] = ur - vr;     hi[2 * j + 1] = ui - vi;
+    }
+}
+
+// The last two levels fused (as kernel_body::radix4_pass); bit-reversed
+// quarters hold residues 0, 2, 1, 3 (mod 4)
+template <size_t N, bool Invert>
+CODELET_INLINE void combine4(double* a) {
+    constexpr size_t Q = N / 4;
+    constexpr double sign = Invert ? -1.0 : 1.0;
+    const std::array<Twiddle, N / 2>& tw = Twiddles<N>::table;
+    double* p0 = a;
+    double* p1 = p0 + 2 * Q;
+    double* p2 = p1 + 2 * Q;
+    double* p3 = p2 + 2 * Q;
+    for (size_t j = 0; j < Q; j++) {
+        double w1r = tw[j].re, w1i = sign * tw[j].im;
+        double w2r = tw[2 * j].re, w2i = sign * tw[2 * j].im;
+
+        double a0r = p0[2 * j], a0i = p0[2 * j + 1];
+        double a1r = p1[2 * j], a1i = p1[2 * j + 1];
+        double a2r = p2[2 * j], a2i = p2[2 * j + 1];
+        double a3r = p3[2 * j], a3i = p3[2 * j + 1];
+
+        double t1r = w2r * a1r - w2i * a1i, t1i = w2r * a1i + w2i * a1r;
+        double t3r = w2r * a3r - w2i * a3i, t3i = w2r * a3i + w2i * a3r;
+
+        double e0r = a0r + t1r, e0i = a0i + t1i, e1r = a0r - t1r, e1i = a0i - t1i;
+        double o0r = a2r + t3r, o0i = a2i + t3i, o1r = a2r - t3r, o1i = a2i - t3i;
+
+        double u0r = w1r * o0r - w1i * o0i, u0i = w1r * o0i + w1i * o0r;
+        double r1r = sign * o1i, r1i = -sign * o1r;
+        double u1r = w1r * r1r - w1i * r1i, u1i = w1r * r1i + w1i * r1r;
+
+        p0[2 * j] = e0r + u0r;  p0[2 * j + 1] = e0i + u0i;
+        p2[2 * j] = e0r - u0r;  p2[2 * j + 1] = e0i - u0i;
+        p1[2 * j] = e1r + u1r;  p1[2 * j + 1] = e1i + u1i;
+        p3[2 * j] = e1r - u1r;  p3[2 * j + 1] = e1i - u1i;
+    }
+}
+
+// Straight-line codelets, 2..STRAIGHT_LINE_MAX. Bit-reversed input: the first
+// half is the even-index sub-transform (itself bit-reversed), the second half
+// the odd one
+template <size_t N, bool Invert>
+CODELET_INLINE void straight_line(double* a) {
+    if constexpr (N > 2) {
+        straight_line<N / 2, Invert>(a);
+        straight_line<N / 2, Invert>(a + N);
+    }
+    combine_unrolled<N, Invert>(a, std::make_index_sequence<N / 2>());
+}
+
+using Codelet = void (*)(double*);
+
+// log2(MAX_SIZE) entries per direction: sizes 2, 4, ..., MAX_SIZE
+constexpr size_t TABLE_SIZE = 10;
+static_assert(((size_t)1 << TABLE_SIZE) == MAX_SIZE, "TABLE_SIZE must match MAX_SIZE");
+
+struct CodeletTable {
+    Codelet forward[TABLE_SIZE];
+    Codelet inverse[TABLE_SIZE];
+};
+
+}  // namespace codelets
+
+// Compiled once per ISA like the kernels in cpu_dispatch.h. Composed sizes
+// recurse on quarter-size codelets with a fused radix-4 combine (radix-2 for
+// the one odd level).
+#define CODELET_VARIANT_SET(suffix, TARGET)                                                             \
+    namespace codelets_##suffix {                                                                       \
+    template <size_t N, bool Invert>                                                                    \
+    TARGET void run(double* a) {                                                                        \
+        if constexpr (N <= codelets::STRAIGHT_LINE_MAX) {                                               \
+            codelets::straight_line<N, Invert>(a);                                                      \
+        } else if constexpr (N / 4 >= codelets::STRAIGHT_LINE_MAX) {                                    \
+            for (size_t q = 0; q < 4; q++) run<N / 4, Invert>(a + q * (N / 2));                         \
+            codelets::combine4<N, Invert>(a);                                                           \
+        } else {                                                                                        \
+            run<N / 2, Invert>(a);                                                                      \
+            run<N / 2, Invert>(a + N);                                                                  \
+            codelets::combine2<N, Invert>(a);                                                           \
+        }                                                                                               \
+    }                                                                                                   \
+    template <size_t... L>                                                                              \
+    inline const codelets::CodeletTable& make_table(std::index_sequence<L...>) {                        \
+        static const codelets::CodeletTable t = {{&run<(size_t)2 << L, false>...},                      \
+                                                 {&run<(size_t)2 << L, true>...}};                      \
+        return t;                                                                                       \
+    }                                                                                                   \
+    inline const codelets::CodeletTable& table() {                                                      \
+        return make_table(std::make_index_sequence<codelets::TABLE_SIZE>());                            \
+    }                                                                                                   \
+    }
+
+CODELET_VARIANT_SET(generic, DISPATCH_TARGET_GENERIC)
+#if MERSENNE_ISA_DISPATCH
+CODELET_VARIANT_SET(avx2, DISPATCH_TARGET_AVX2)
+CODELET_VARIANT_SET(avx512, DISPATCH_TARGET_AVX512)
+#endif
+
+namespace codelets {
+
+// Codelet for a size-n transform built for the same ISA as kernels(), or
+// nullptr when n is not a codelet size
+inline Codelet codelet_for(size_t n, bool invert) {
+    static const CodeletTable* selected = []() {
+        #if MERSENNE_ISA_DISPATCH
+        std::string isa = kernels().isa_name;
+        if (isa == "avx512") return &codelets_avx512::table();
+        if (isa == "avx2") return &codelets_avx2::table();
+        #endif
+        return &codelets_generic::table();
+    }();
+    if (n < 2 || n > MAX_SIZE || (n & (n - 1)) != 0) return nullptr;
+    size_t index = 0;
+    while (((size_t)2 << index) < n) index++;
+    return invert ? selected->inverse[index] : selected->forward[index];
+}
+
+}  // namespace codelets
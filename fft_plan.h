@@ -0,0 +1,543 @@
+/*
+🧭 FFT PLANS WITH PER-HOST WISDOM 🧭
+FFTW-style planning for the complex FFTs used by the engines.
+
+A plan fixes the radix ordering, the cache blocking factor, whether the
+blocked leaf levels run as compile-time codelets (fft_codelets.h), an optional
+four-step split and the thread count for one transform length. Plans are
+either timed on this host (tune) or read from a wisdom file keyed by CPU
+model, so every host runs its own fastest variant instead of the fixed
+FFT_SIZE / CACHE_LINE / THREAD_CACHE_SIZE choices.
+
+Wisdom file: fft_wisdom.txt (override with MERSENNE_FFT_WISDOM), one line per
+(cpu model, length); lines for other CPU models are preserved on save.
+Run fft_tuner to (re)generate it.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpu_dispatch.h"
+#include "fft_codelets.h"
+#include "shared_tables.h"
+#include "trace_recorder.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+struct FFTPlan {
+    size_t n = 0;
+    int radix = 2;              // 2 = radix-2 passes, 4 = fused radix-4 passes
+    size_t block = 1024;        // Leading stages run depth-first over blocks of this size
+    size_t four_step_rows = 0;  // 0 = direct transform, else n = rows * cols
+    int threads = 1;
+    double ns_per_transform = 0;  // Measured cost (0 = heuristic plan)
+    int leaf_codelets = 0;      // 1 = blocks of <= codelets::MAX_SIZE run as one codelet
+
+    std::string describe() const {
+        std::stringstream s;
+        s << "n=" << n << " radix=" << radix << " block=" << block
+          << " four_step_rows=" << four_step_rows << " threads=" << threads
+          << " codelets=" << leaf_codelets;
+        return s.str();
+    }
+};
+
+// Persistent helper threads for FFTPlanner::parallel_for: spawned on first
+// use and woken for each pass, instead of a fresh std::thread per pass. One
+// job runs at a time; a caller that finds the pool busy (another engine
+// thread transforming concurrently) runs its loop inline. A thread can
+// install a pool of its own (FFTThreadPool::Scope) so its transforms get
+// dedicated helpers instead of contending for the shared one.
+class FFTThreadPool {
+public:
+    using Body = void (*)(void* context, size_t lo, size_t hi);
+
+private:
+    std::mutex job_mutex;   // Held by the caller for the whole job
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    std::vector<std::thread> helpers;
+    bool stopping = false;
+
+    uint64_t generation = 0;
+    int helpers_wanted = 0;
+    int pending = 0;   // Helpers still inside the current job
+    Body body = nullptr;
+    void* context = nullptr;
+    size_t count = 0, chunk = 1;
+    std::atomic<size_t> next_chunk{0};
+
+    static FFTThreadPool*& installed() {
+        thread_local FFTThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    void run_chunks() {
+        for (size_t c; (c = next_chunk.fetch_add(1)) * chunk < count;) {
+            body(context, c * chunk, std::min(count, (c + 1) * chunk));
+        }
+    }
+
+    void worker_loop(int id, uint64_t seen) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return generation != seen || stopping; });
+            if (stopping) return;
+            seen = generation;
+            if (id >= helpers_wanted) continue;
+            lock.unlock();
+            run_chunks();
+            lock.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+public:
+    FFTThreadPool() = default;
+    FFTThreadPool(const FFTThreadPool&) = delete;
+    FFTThreadPool& operator=(const FFTThreadPool&) = delete;
+
+    ~FFTThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : helpers) t.join();
+    }
+
+    // Intentionally leaked: its helpers live for the process
+    static FFTThreadPool& instance() {
+        static FFTThreadPool* pool = new FFTThreadPool();
+        return *pool;
+    }
+
+    // The calling thread's pool: its Scope's if one is installed, else the shared one
+    static FFTThreadPool& current() {
+        FFTThreadPool* pool = installed();
+        return pool ? *pool : instance();
+    }
+
+    // Routes the calling thread's parallel loops to `pool` while alive
+    class Scope {
+    private:
+        FFTThreadPool* previous;
+
+    public:
+        explicit Scope(FFTThreadPool& pool) : previous(installed()) { installed() = &pool; }
+        ~Scope() { installed() = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // fn(lo, hi) over [0, count) in `chunk`-sized pieces on `threads` threads,
+    // the caller included. Returns false (nothing run) if the pool is busy.
+    bool run(int threads, size_t job_count, size_t job_chunk, Body job_body, void* job_context) {
+        std::unique_lock<std::mutex> job(job_mutex, std::try_to_lock);
+        if (!job.owns_lock()) return false;
+        int wanted = threads - 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while ((int)helpers.size() < wanted) {
+                helpers.emplace_back(&FFTThreadPool::worker_loop, this, (int)helpers.size(), generation);
+            }
+            body = job_body;
+            context = job_context;
+            count = job_count;
+            chunk = std::max<size_t>(1, job_chunk);
+            next_chunk = 0;
+            helpers_wanted = wanted;
+            pending = wanted;
+            generation++;
+        }
+        wake.notify_all();
+        run_chunks();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+        return true;
+    }
+
+    // fn(lo, hi) split evenly over `threads` threads of the current pool;
+    // inline when single-threaded or the pool is busy
+    template <typename Fn>
+    static void parallel_for(int threads, size_t count, Fn fn) {
+        if (threads <= 1 || count < 2) {
+            fn(0, count);
+            return;
+        }
+        threads = (int)std::min<size_t>(threads, count);
+        size_t chunk = (count + threads - 1) / threads;
+        Body body = [](void* context, size_t lo, size_t hi) { (*static_cast<Fn*>(context))(lo, hi); };
+        if (!current().run(threads, count, chunk, body, &fn)) fn(0, count);
+    }
+};
+
+class FFTPlanner {
+private:
+    std::mutex planner_mutex;
+    std::map<size_t, FFTPlan> wisdom;                                  // This host's winners
+    std::string cpu_model;
+    std::string wisdom_path;
+
+    FFTPlanner() {
+        cpu_model = detect_cpu_model();
+        const char* env = std::getenv("MERSENNE_FFT_WISDOM");
+        wisdom_path = env ? env : "fft_wisdom.txt";
+        load_wisdom();
+    }
+
+    // ========================================
+    // HOST IDENTIFICATION
+    // ========================================
+
+    static std::string detect_cpu_model() {
+        std::string model;
+        #if defined(__x86_64__) || defined(__i386__)
+        unsigned int regs[12];
+        if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004) {
+            for (unsigned int i = 0; i < 3; i++) {
+                __get_cpuid(0x80000002 + i, &regs[i * 4], &regs[i * 4 + 1], &regs[i * 4 + 2], &regs[i * 4 + 3]);
+            }
+            model.assign(reinterpret_cast<const char*>(regs), sizeof(regs));
+        }
+        #else
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.find("model name") == 0 || line.find("CPU part") == 0) {
+                model = line.substr(line.find(':') + 1);
+                break;
+            }
+        }
+        #endif
+        // Normalize: printable, no separators used by the wisdom format
+        std::string clean;
+        for (char c : model) {
+            if (c == '\0') break;
+            if (c == '|' || c == '\n' || c == '\r') continue;
+            if (c == ' ' && (clean.empty() || clean.back() == ' ')) continue;
+            clean += c;
+        }
+        while (!clean.empty() && clean.back() == ' ') clean.pop_back();
+        return clean.empty() ? "unknown-cpu" : clean;
+    }
+
+    // ========================================
+    // WISDOM FILE
+    // ========================================
+
+    void load_wisdom() {
+        std::ifstream file(wisdom_path);
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t bar = line.find('|');
+            if (bar == std::string::npos || line.substr(0, bar) != cpu_model) continue;
+
+            std::stringstream fields(line.substr(bar + 1));
+            FFTPlan plan;
+            if (fields >> plan.n >> plan.radix >> plan.block >> plan.four_step_rows
+                       >> plan.threads >> plan.ns_per_transform) {
+                // Optional trailing field: wisdom from before codelets has none
+                if (!(fields >> plan.leaf_codelets)) plan.leaf_codelets = 0;
+                wisdom[plan.n] = plan;
+            }
+        }
+    }
+
+public:
+    static FFTPlanner& instance() {
+        static FFTPlanner planner;
+        return planner;
+    }
+
+    const std::string& host_cpu_model() const { return cpu_model; }
+    size_t wisdom_entries() const { return wisdom.size(); }
+
+    bool save_wisdom() {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+
+        // Keep other hosts' entries - one file can serve a heterogeneous fleet
+        std::vector<std::string> foreign;
+        {
+            std::ifstream file(wisdom_path);
+            std::string line;
+            while (std::getline(file, line)) {
+                size_t bar = line.find('|');
+                if (bar != std::string::npos && line.substr(0, bar) != cpu_model) foreign.push_back(line);
+            }
+        }
+
+        std::ofstream file(wisdom_path);
+        if (!file.is_open()) return false;
+        for (const auto& line : foreign) file << line << "\n";
+        for (const auto& [n, plan] : wisdom) {
+            file << cpu_model << "|" << plan.n << " " << plan.radix << " " << plan.block << " "
+                 << plan.four_step_rows << " " << plan.threads << " " << plan.ns_per_transform << " "
+                 << plan.leaf_codelets << "\n";
+        }
+        return true;
+    }
+
+    // ========================================
+    // PLANNING
+    // ========================================
+
+    // Tuned plan from wisdom, else a conservative heuristic
+    FFTPlan plan_for(size_t n) {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        auto it = wisdom.find(n);
+        if (it != wisdom.end()) return it->second;
+
+        FFTPlan plan;
+        plan.n = n;
+        plan.radix = 4;
+        plan.block = std::min<size_t>(n, 1024);  // 16KB of complex<double>: fits L1
+        plan.four_step_rows = 0;
+        plan.threads = 1;
+        plan.leaf_codelets = 1;
+        return plan;
+    }
+
+    // Candidate variants worth timing for length n
+    std::vector<FFTPlan> candidate_plans(size_t n, int max_threads) {
+        std::vector<FFTPlan> candidates;
+        std::vector<int> thread_counts = {1};
+        for (int t = 2; t <= max_threads; t *= 2) thread_counts.push_back(t);
+        if (thread_counts.back() != max_threads && max_threads > 1) thread_counts.push_back(max_threads);
+
+        for (int radix : {2, 4}) {
+            for (size_t block = std::min<size_t>(n, 256); block <= std::min<size_t>(n, 16384); block *= 4) {
+                for (int threads : thread_counts) {
+                    // Threads only pay off when there is enough work per thread
+                    if (threads > 1 && n < 16384) continue;
+                    FFTPlan plan;
+                    plan.n = n; plan.radix = radix; plan.block = block; plan.threads = threads;
+                    candidates.push_back(plan);
+                    if (block <= codelets::MAX_SIZE) {
+                        FFTPlan leaf = plan;
+                        leaf.leaf_codelets = 1;
+                        candidates.push_back(leaf);
+                    }
+
+                    // Four-step: split near sqrt(n) so both passes are cache resident
+                    if (n >= 65536) {
+                        size_t rows = 1;
+                        while (rows * rows < n) rows <<= 1;
+                        for (size_t r : {rows / 2, rows, rows * 2}) {
+                            if (r < 64 || n / r < 64) continue;
+                            FFTPlan split = plan;
+                            split.four_step_rows = r;
+                            candidates.push_back(split);
+                        }
+                    }
+                }
+            }
+        }
+        return candidates;
+    }
+
+    // Time every candidate for length n and remember the fastest
+    FFTPlan tune(size_t n, int max_threads = std::max(1u, std::thread::hardware_concurrency())) {
+        std::vector<std::complex<double>> data(n), work(n);
+        for (size_t i = 0; i < n; i++) data[i] = {std::sin(i * 0.37), std::cos(i * 0.11)};
+
+        FFTPlan best;
+        best.ns_per_transform = 1e300;
+        for (FFTPlan plan : candidate_plans(n, max_threads)) {
+            // Enough repetitions for ~20ms of work, minimum 3
+            int reps = std::max<int>(3, (int)(2e7 / (5.0 * n * std::log2((double)n) + 1)));
+            work = data;
+            execute(plan, work, false);  // Warm caches and twiddle tables
+
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) {
+                execute(plan, work, (r & 1) != 0);
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reps;
+
+            if (ns < best.ns_per_transform) {
+                best = plan;
+                best.ns_per_transform = ns;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        wisdom[n] = best;
+        return best;
+    }
+
+    // ========================================
+    // EXECUTION
+    // ========================================
+
+    // Unnormalized in-place transform; invert applies the conjugate kernel and 1/n.
+    // One trace span per transform: the passes and four-step sub-transforms
+    // underneath would flood the per-thread trace ring.
+    void execute(const FFTPlan& plan, std::complex<double>* a, size_t n, bool invert) {
+        if (n <= 1) return;
+
+        if (plan.four_step_rows && plan.four_step_rows < n && n % plan.four_step_rows == 0) {
+            TraceSpan span("fft_four_step", "fft", n);
+            four_step(plan, a, n, invert);
+        } else {
+            TraceSpan span("fft_direct", "fft", n);
+            direct(plan, a, n, invert);
+        }
+
+        if (invert) {
+            double scale = 1.0 / n;
+            for (size_t i = 0; i < n; i++) a[i] *= scale;
+        }
+    }
+
+    void execute(const FFTPlan& plan, std::vector<std::complex<double>>& a, bool invert) {
+        execute(plan, a.data(), a.size(), invert);
+    }
+
+    void execute(std::vector<std::complex<double>>& a, bool invert) {
+        execute(plan_for(a.size()), a, invert);
+    }
+
+private:
+    // exp(-2*pi*i*k/n) for k < n, shared by every plan of length n (and every
+    // process on the node - see shared_tables.h)
+    static const std::complex<double>* twiddles(size_t n) {
+        return TableRegistry::instance().twiddles(n);
+    }
+
+    template <typename Fn>
+    static void parallel_for(int threads, size_t count, Fn fn) {
+        FFTThreadPool::parallel_for(threads, count, fn);
+    }
+
+    // Per-thread scratch that only grows, so repeated transforms don't touch
+    // the heap: slot 0 is the calling thread's transpose buffer, slot 1 the
+    // column / row gather of whichever thread runs a piece
+    static std::complex<double>* scratch(int slot, size_t n) {
+        thread_local std::vector<std::complex<double>> buffers[2];
+        if (buffers[slot].size() < n) buffers[slot].resize(n);
+        return buffers[slot].data();
+    }
+
+    static void bit_reverse(std::complex<double>* a, size_t n) {
+        for (size_t i = 1, j = 0; i < n; i++) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+    }
+
+    // Passes of length first_len .. last_len (inclusive) over [base, base + span)
+    static void run_passes(const FFTPlan& plan, std::complex<double>* a, size_t base, size_t span,
+                           size_t first_len, size_t last_len, const std::complex<double>* tw,
+                           size_t n, bool invert) {
+        // Butterflies come from the host's ISA kernel set (cpu_dispatch.h)
+        const KernelTable& k = kernels();
+        double* data = reinterpret_cast<double*>(a);
+        const double* twiddle = reinterpret_cast<const double*>(tw);
+        size_t len = first_len;
+        while (len <= last_len) {
+            if (plan.radix == 4 && len * 2 <= last_len) {
+                k.radix4_pass(data, base, span, len * 2, twiddle, n, invert);
+                len *= 4;
+            } else {
+                k.radix2_pass(data, base, span, len, twiddle, n, invert);
+                len *= 2;
+            }
+        }
+    }
+
+    void direct(const FFTPlan& plan, std::complex<double>* a, size_t n, bool invert) {
+        const std::complex<double>* tw = twiddles(n);
+        bit_reverse(a, n);
+
+        // Depth-first: all passes up to `block` stay inside one cache-sized block,
+        // as one straight-line / composed codelet when the plan asks for it
+        size_t block = std::max<size_t>(2, std::min(plan.block, n));
+        size_t blocks = n / block;
+        codelets::Codelet leaf = plan.leaf_codelets ? codelets::codelet_for(block, invert) : nullptr;
+        parallel_for(plan.threads, blocks, [&](size_t lo, size_t hi) {
+            for (size_t b = lo; b < hi; b++) {
+                if (leaf) {
+                    leaf(reinterpret_cast<double*>(a + b * block));
+                } else {
+                    run_passes(plan, a, b * block, block, 2, block, tw, n, invert);
+                }
+            }
+        });
+
+        // Breadth-first for the remaining long passes
+        size_t len = block * 2;
+        while (len <= n) {
+            bool fuse = plan.radix == 4 && len * 2 <= n;
+            size_t pass_len = fuse ? len * 2 : len;
+            size_t groups = n / pass_len;
+            if (groups >= (size_t)plan.threads) {
+                parallel_for(plan.threads, groups, [&](size_t lo, size_t hi) {
+                    run_passes(plan, a, lo * pass_len, (hi - lo) * pass_len, len, pass_len, tw, n, invert);
+                });
+            } else {
+                run_passes(plan, a, 0, n, len, pass_len, tw, n, invert);
+            }
+            len = pass_len * 2;
+        }
+    }
+
+    // n = rows * cols: column FFTs, twiddle, row FFTs, with gathers so each
+    // sub-transform runs contiguously in cache
+    void four_step(const FFTPlan& plan, std::complex<double>* a, size_t n, bool invert) {
+        size_t rows = plan.four_step_rows, cols = n / rows;
+        const std::complex<double>* tw = twiddles(n);
+
+        FFTPlan sub = plan;
+        sub.four_step_rows = 0;
+        sub.threads = 1;
+
+        std::complex<double>* temp = scratch(0, n);
+
+        // Step 1: length-rows FFT down each column, times W_n^(col*k), stored transposed
+        parallel_for(plan.threads, cols, [&](size_t lo, size_t hi) {
+            std::complex<double>* column = scratch(1, rows);
+            for (size_t c = lo; c < hi; c++) {
+                for (size_t r = 0; r < rows; r++) column[r] = a[r * cols + c];
+                FFTPlan column_plan = sub;
+                column_plan.n = rows;
+                direct(column_plan, column, rows, invert);
+                for (size_t k = 0; k < rows; k++) {
+                    std::complex<double> w = tw[(c * k) % n];
+                    temp[c * rows + k] = column[k] * (invert ? std::conj(w) : w);
+                }
+            }
+        });
+
+        // Step 2: length-cols FFT across, output index k1 + rows * k2
+        parallel_for(plan.threads, rows, [&](size_t lo, size_t hi) {
+            std::complex<double>* row = scratch(1, cols);
+            for (size_t k1 = lo; k1 < hi; k1++) {
+                for (size_t c = 0; c < cols; c++) row[c] = temp[c * rows + k1];
+                FFTPlan row_plan = sub;
+                row_plan.n = cols;
+                direct(row_plan, row, cols, invert);
+                for (size_t k2 = 0; k2 < cols; k2++) a[k1 + rows * k2] = row[k2];
+            }
+        });
+    }
+};
@@ -0,0 +1,62 @@
+/*
+🧭 FFT TUNER 🧭
+Times candidate FFT plans for each transform length the engines use and
+stores the winners in the per-host wisdom file loaded by FFTPlanner.
+
+Usage: fft_tuner [max_threads] [length ...]
+Default lengths: every power of two from 2^6 to 2^20 (covers FFT_SIZE and
+the FFTMultiplier / UpgradedLucasLehmer product sizes).
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+
+#include "fft_plan.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+
+    int max_threads = max(1u, thread::hardware_concurrency());
+    if (argc >= 2) max_threads = max(1, atoi(argv[1]));
+
+    vector<size_t> lengths;
+    for (int i = 2; i < argc; i++) {
+        size_t n = strtoull(argv[i], nullptr, 10);
+        if (n < 2 || (n & (n - 1)) != 0) {
+            cerr << "Skipping " << argv[i] << ": length must be a power of two >= 2\n";
+            continue;
+        }
+        lengths.push_back(n);
+    }
+    if (lengths.empty()) {
+        for (size_t n = 64; n <= (1u << 20); n <<= 1) lengths.push_back(n);
+    }
+
+    FFTPlanner& planner = FFTPlanner::instance();
+    cout << "🧭 Tuning FFT plans for: " << planner.host_cpu_model() << endl;
+    cout << "🧵 Max threads: " << max_threads << endl;
+    cout << "========================================" << endl;
+
+    for (size_t n : lengths) {
+        FFTPlan baseline = planner.plan_for(n);
+        FFTPlan best = planner.tune(n, max_threads);
+        cout << setw(8) << n << "  " << best.describe() << "  "
+             << fixed << setprecision(1) << best.ns_per_transform / 1000.0 << " us";
+        if (baseline.ns_per_transform > 0) {
+            cout << "  (previous " << baseline.ns_per_transform / 1000.0 << " us)";
+        }
+        cout << endl;
+    }
+
+    if (!planner.save_wisdom()) {
+        cerr << "❌ Could not write wisdom file\n";
+        return 1;
+    }
+    cout << "✅ Wisdom saved (" << planner.wisdom_entries() << " lengths for this CPU)" << endl;
+    return 0;
+}
@@ -8,11 +8,17 @@ Checks only prime exponents → Big reduction in work.
 
 Uses Lucas–Lehmer test, which is optimal for Mersenne primes.
 
-Custom big integer struct → Much faster than GMP for moderate sizes.
+Shared big-integer core (big_int.h) → Karatsuba/FFT squaring, shift-add Mersenne reduction.
 
-No extra heap allocations per iteration → Keeps vectors reused.
+No extra heap allocations per iteration → Fused s = (s*s - 2) % m reuses per-thread scratch.
 
+Sweep mode → Every prime p up to N on all cores, grouped by size class,
+streamed as each test finishes. Every run tests every exponent (a health
+check for a new host) unless --checkpoint FILE is given: then results are
+appended to FILE and exponents already in it are resumed, not re-tested.
 
+Usage: new_final_alltest                         (prompts for the limit)
+       new_final_alltest --sweep N [--threads T] [--checkpoint FILE]
 
 
 
@@ -33,135 +39,262 @@ No extra heap allocations per iteration → Keeps vectors reused.
 
 
 #include <bits/stdc++.h>
-using namespace std;
 
-// ------------------------
-// Fast big integer using vector<uint32_t>
-// ------------------------
-struct BigInt {
-    vector<uint32_t> d; // base 2^32
+#include "../big_int.h"
 
-    BigInt(uint64_t val = 0) {
-        if (val) d.push_back((uint32_t)val);
-        uint32_t high = (uint32_t)(val >> 32);
-        if (high) d.push_back(high);
-    }
+using namespace std;
 
-    void trim() {
-        while (!d.empty() && d.back() == 0) d.pop_back();
+// Lucas–Lehmer test for Mersenne prime 2^p - 1
+bool lucas_lehmer_test(int p) {
+    if (p == 2) return true;
+    BigInt m = BigInt::mersenne(p);
+    BigInt s = 4;
+    for (int i = 0; i < p - 2; i++) {
+        s = (s * s - 2) % m;
     }
+    return s.is_zero();
+}
 
-    static BigInt modmul(const BigInt &a, const BigInt &b, const BigInt &mod) {
-        BigInt res;
-        res.d.assign(a.d.size() + b.d.size(), 0);
-        for (size_t i = 0; i < a.d.size(); i++) {
-            uint64_t carry = 0;
-            for (size_t j = 0; j < b.d.size() || carry; j++) {
-                uint64_t cur = res.d[i + j] +
-                               (uint64_t)a.d[i] * (j < b.d.size() ? b.d[j] : 0) +
-                               carry;
-                res.d[i + j] = (uint32_t)cur;
-                carry = cur >> 32;
-            }
+// Word-sized exponents, several at once: independent lanes interleave in one
+// loop, so the multiplies of one lane hide the latency of the others
+constexpr int LANES = 8;
+constexpr int WORD_LIMIT = 63;
+
+void lucas_lehmer_lanes(const int* exponents, int count, bool* results) {
+    uint64_t s[LANES], m[LANES];
+    int iterations = 0;
+    for (int l = 0; l < count; l++) {
+        s[l] = 4;
+        m[l] = (1ULL << exponents[l]) - 1;
+        iterations = max(iterations, exponents[l] - 2);
+    }
+    for (int i = 0; i < iterations; i++) {
+        for (int l = 0; l < count; l++) {
+            if (i >= exponents[l] - 2) continue;
+            int p = exponents[l];
+            __uint128_t x = (__uint128_t)s[l] * s[l];
+            uint64_t r = (uint64_t)(x & m[l]) + (uint64_t)(x >> p);   // x mod 2^p - 1, folded
+            r = (r & m[l]) + (r >> p);
+            if (r >= m[l]) r -= m[l];
+            s[l] = r >= 2 ? r - 2 : r + m[l] - 2;
         }
-        return res.mod(mod);
     }
+    for (int l = 0; l < count; l++) {
+        results[l] = exponents[l] == 2 || s[l] == 0 || s[l] == m[l];
+    }
+}
+
+// Sieve of Eratosthenes: all primes up to limit
+vector<int> primes_up_to(int limit) {
+    vector<int> primes;
+    if (limit < 2) return primes;
+    vector<bool> composite(limit + 1, false);
+    for (int i = 2; i <= limit; i++) {
+        if (composite[i]) continue;
+        primes.push_back(i);
+        for (long long j = 1LL * i * i; j <= limit; j += i) composite[j] = true;
+    }
+    return primes;
+}
+
+// ========================================
+// SWEEP MODE
+// ========================================
+
+// Size class of 2^p - 1: word lanes, then one class per power-of-two limb
+// count. Every exponent in a class squares through the same BigInt tier at
+// about the same length, so a worker's thread-local scratch, FFT plan and
+// NTT root table stay sized for it instead of being rebuilt test by test.
+int size_class(int p) {
+    if (p <= WORD_LIMIT) return 0;
+    size_t limbs = (p + 63) / 64;
+    int cls = 1;
+    while (((size_t)1 << (cls - 1)) < limbs) cls++;
+    return cls;
+}
+
+struct SweepTask {
+    int size_class;
+    vector<int> exponents;   // Up to LANES in class 0, otherwise one
+};
 
-    BigInt mod(const BigInt &m) const {
-        BigInt res = *this;
-        res %= m;
-        return res;
+struct SweepResult {
+    int p;
+    bool prime;
+};
+
+// Completed exponents, one "p 0|1" line each, appended as tests finish.
+// An empty path disables it: nothing is loaded or written.
+class SweepCheckpoint {
+private:
+    string path;
+    ofstream out;
+
+public:
+    explicit SweepCheckpoint(const string& file) : path(file) {}
+
+    bool enabled() const { return !path.empty(); }
+    const string& file() const { return path; }
+
+    map<int, bool> load() const {
+        map<int, bool> done;
+        if (!enabled()) return done;
+        ifstream in(path);
+        int p, prime;
+        while (in >> p >> prime) done[p] = prime != 0;
+        return done;
     }
 
-    void operator%=(const BigInt &m) {
-        if (cmp(*this, m) < 0) return;
-        BigInt cur;
-        cur.d.assign(d.size(), 0);
-        for (int i = (int)d.size() * 32 - 1; i >= 0; i--) {
-            cur <<= 1;
-            cur.d[0] |= (d[i / 32] >> (i % 32)) & 1U;
-            if (cmp(cur, m) >= 0)
-                cur = sub(cur, m);
-        }
-        *this = cur;
-        trim();
+    void open() {
+        if (!enabled()) return;
+        out.open(path, ios::app);
+        if (!out) throw runtime_error("cannot open checkpoint file " + path);
     }
 
-    static int cmp(const BigInt &a, const BigInt &b) {
-        if (a.d.size() != b.d.size()) return a.d.size() < b.d.size() ? -1 : 1;
-        for (int i = (int)a.d.size() - 1; i >= 0; i--)
-            if (a.d[i] != b.d[i]) return a.d[i] < b.d[i] ? -1 : 1;
-        return 0;
+    void record(int p, bool prime) {
+        if (!enabled()) return;
+        out << p << ' ' << (prime ? 1 : 0) << '\n';
+        out.flush();
     }
+};
 
-    static BigInt sub(const BigInt &a, const BigInt &b) {
-        BigInt res = a;
-        uint64_t carry = 0;
-        for (size_t i = 0; i < b.d.size() || carry; i++) {
-            uint64_t cur = res.d[i] - (i < b.d.size() ? b.d[i] : 0) - carry;
-            carry = (cur >> 63);
-            res.d[i] = (uint32_t)cur;
+class ExhaustiveSweep {
+private:
+    int limit;
+    unsigned threads;
+    SweepCheckpoint checkpoint;
+
+    vector<SweepTask> tasks;
+    atomic<size_t> next_task{0};
+
+    mutex output_mutex;
+    vector<SweepResult> results;
+    size_t tested = 0, pending = 0;
+    chrono::steady_clock::time_point start;
+
+    // Largest classes first so the long tests start early and the small ones
+    // fill in the tail; exponents stay grouped by class within that order
+    void plan(const vector<int>& exponents) {
+        map<int, vector<int>, greater<int>> classes;
+        for (int p : exponents) classes[size_class(p)].push_back(p);
+
+        for (auto& [cls, members] : classes) {
+            size_t step = cls == 0 ? LANES : 1;
+            for (size_t i = 0; i < members.size(); i += step) {
+                size_t end = min(members.size(), i + step);
+                tasks.push_back({cls, vector<int>(members.begin() + i, members.begin() + end)});
+            }
         }
-        res.trim();
-        return res;
     }
 
-    void operator<<=(int shift) {
-        if (!shift) return;
-        int word_shift = shift / 32;
-        int bit_shift = shift % 32;
-        if (bit_shift == 0) {
-            d.insert(d.begin(), word_shift, 0);
-        } else {
-            uint32_t carry = 0;
-            for (size_t i = 0; i < d.size(); i++) {
-                uint64_t cur = ((uint64_t)d[i] << bit_shift) | carry;
-                d[i] = (uint32_t)cur;
-                carry = cur >> 32;
+    void report(const SweepTask& task, const bool* prime, double seconds) {
+        lock_guard<mutex> lock(output_mutex);
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (size_t i = 0; i < task.exponents.size(); i++) {
+            int p = task.exponents[i];
+            checkpoint.record(p, prime[i]);
+            results.push_back({p, prime[i]});
+            tested++;
+            if (prime[i]) {
+                cout << "🎉 M" << p << " is prime";
+            } else {
+                cout << "   M" << p << " composite";
             }
-            if (carry) d.push_back(carry);
-            d.insert(d.begin(), word_shift, 0);
+            cout << "  [class " << task.size_class << ", " << fixed << setprecision(3) << seconds
+                 << " s, " << tested << "/" << pending << ", " << setprecision(1) << elapsed << " s elapsed]\n";
         }
+        cout.flush();
     }
-};
 
-// Lucas–Lehmer test for Mersenne prime 2^p - 1
-bool lucas_lehmer_test(int p) {
-    if (p == 2) return true;
-    BigInt m = (BigInt(1) << p) - BigInt(1);
-    BigInt s = 4;
-    for (int i = 0; i < p - 2; i++) {
-        s = BigInt::modmul(s, s, m);
-        s = BigInt::sub(s, BigInt(2));
+    void worker() {
+        for (;;) {
+            size_t index = next_task.fetch_add(1);
+            if (index >= tasks.size()) return;
+            const SweepTask& task = tasks[index];
+
+            auto t0 = chrono::steady_clock::now();
+            bool prime[LANES];
+            if (task.size_class == 0) {
+                lucas_lehmer_lanes(task.exponents.data(), (int)task.exponents.size(), prime);
+            } else {
+                prime[0] = lucas_lehmer_test(task.exponents[0]);
+            }
+            report(task, prime, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+        }
     }
-    return s.d.empty();
-}
 
-// Check if n is prime (simple deterministic Miller–Rabin for small p)
-bool is_prime(int n) {
-    if (n < 2) return false;
-    if (n % 2 == 0) return n == 2;
-    for (int i = 3; i * 1LL * i <= n; i += 2)
-        if (n % i == 0) return false;
-    return true;
-}
+public:
+    ExhaustiveSweep(int max_exponent, unsigned thread_count, const string& checkpoint_file)
+        : limit(max_exponent), threads(max(1u, thread_count)), checkpoint(checkpoint_file) {}
+
+    // Returns the prime exponents found, resumed ones included, in order
+    vector<int> run() {
+        map<int, bool> done = checkpoint.load();
+        vector<int> remaining;
+        size_t resumed = 0;
+        for (int p : primes_up_to(limit)) {
+            if (done.count(p)) resumed++;
+            else remaining.push_back(p);
+        }
+        checkpoint.open();
+        plan(remaining);
+        pending = remaining.size();
+
+        cout << "🔁 Sweep of prime exponents up to " << limit << ": " << remaining.size() << " to test, "
+             << threads << " threads" << endl;
+        if (checkpoint.enabled()) {
+            cout << "📂 Resuming from " << checkpoint.file() << ": " << resumed
+                 << " exponents take their earlier verdicts and are NOT re-tested" << endl;
+        }
+
+        start = chrono::steady_clock::now();
+        vector<thread> pool;
+        for (unsigned t = 0; t < threads; t++) pool.emplace_back(&ExhaustiveSweep::worker, this);
+        for (thread& t : pool) t.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-int main() {
+        vector<int> found;
+        for (auto& [p, prime] : done) {
+            if (prime && p <= limit) found.push_back(p);
+        }
+        for (const SweepResult& r : results) {
+            if (r.prime) found.push_back(r.p);
+        }
+        sort(found.begin(), found.end());
+
+        cout << "⏱️ " << tested << " tests in " << fixed << setprecision(2) << seconds << " s ("
+             << setprecision(1) << (seconds > 0 ? tested / seconds : 0.0) << " tests/s)" << endl;
+        return found;
+    }
+};
+
+int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
-    int limit;
-    cout << "Enter max exponent limit: ";
-    cin >> limit;
-
-    cout << "Mersenne prime exponents up to " << limit << ":\n";
-    for (int p = 2; p <= limit; p++) {
-        if (is_prime(p)) {
-            if (lucas_lehmer_test(p)) {
-                cout << p << " ";
-            }
-        }
+    int limit = 0;
+    unsigned threads = thread::hardware_concurrency();
+    string checkpoint_file;   // Resume is opt-in: without it every exponent is re-tested
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sweep" && i + 1 < argc) limit = atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpoint_file = argv[++i];
+    }
+
+    if (limit == 0) {
+        cout << "Enter max exponent limit: ";
+        cin >> limit;
+    }
+
+    try {
+        vector<int> found = ExhaustiveSweep(limit, threads, checkpoint_file).run();
+        cout << "Mersenne prime exponents up to " << limit << ":\n";
+        for (int p : found) cout << p << " ";
+        cout << "\n";
+    } catch (const exception& e) {
+        cerr << "❌ " << e.what() << endl;
+        return 1;
     }
-    cout << "\n";
     return 0;
 }
@@ -10,36 +10,15 @@ Corrected compilation errors and critical bugs
 #include <atomic>
 #include <mutex>
 
+#include "shared_tables.h"
+
 using namespace std;
 
 class UltraFastLucasLehmer {
 private:
-    vector<uint64_t> small_primes;
+    const vector<uint32_t>& small_primes = TableRegistry::instance().small_primes();  // Sieved once per process
     
 public:
-    UltraFastLucasLehmer() {
-        initialize_small_primes();
-    }
-    
-    void initialize_small_primes() {
-        vector<bool> is_prime(1000000, true);
-        is_prime[0] = is_prime[1] = false;
-        
-        for (int i = 2; i * i < 1000000; i++) {
-            if (is_prime[i]) {
-                for (int j = i * i; j < 1000000; j += i) {
-                    is_prime[j] = false;
-                }
-            }
-        }
-        
-        for (int i = 2; i < 1000000; i++) {
-            if (is_prime[i]) {
-                small_primes.push_back(i);
-            }
-        }
-    }
-    
     bool ultra_fast_lucas_lehmer_test(int p) {
         if (p == 2) return true;
         if (p <= 1 || p % 2 == 0) return false;
@@ -78,32 +57,9 @@ public:
 
 class UltraFastPrimalityTest {
 private:
-    vector<uint64_t> small_primes;
+    const vector<uint32_t>& small_primes = TableRegistry::instance().small_primes();  // Sieved once per process
     
 public:
-    UltraFastPrimalityTest() {
-        initialize_small_primes();
-    }
-    
-    void initialize_small_primes() {
-        vector<bool> is_prime(1000000, true);
-        is_prime[0] = is_prime[1] = false;
-        
-        for (int i = 2; i * i < 1000000; i++) {
-            if (is_prime[i]) {
-                for (int j = i * i; j < 1000000; j += i) {
-                    is_prime[j] = false;
-                }
-            }
-        }
-        
-        for (int i = 2; i < 1000000; i++) {
-            if (is_prime[i]) {
-                small_primes.push_back(i);
-            }
-        }
-    }
-    
     bool ultra_fast_is_prime(uint64_t n) {
         if (n < 2) return false;
         if (n < 4) return true;
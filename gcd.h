@@ -0,0 +1,245 @@
+/*
+🧮 SUBQUADRATIC GCD 🧮
+gcd of multi-million-bit BigInts - P-1's gcd(x - 1, 2^p - 1) at the end of
+each stage - in O(M(n) log n) instead of O(n^2).
+
+- Half-GCD (Schönhage / Möller style): reduce the top halves recursively,
+  lift the cofactor matrix to the full operands with the BigInt multiply
+  tiers (Karatsuba / FFT / NTT), and repeat on the result
+- Below HGCD_THRESHOLD bits: Lehmer steps driven by 64-bit leading words,
+  with a binary GCD once both operands fit in a machine word
+
+Every reduction is (a, b) = M (alpha, beta) with M a non-negative matrix of
+determinant 1, so no signed arithmetic is needed. A reduction of the top bits
+stops while both remainders still exceed its matrix entries, which keeps the
+lifted values non-negative and the result exact.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "big_int.h"
+
+namespace bigint {
+
+constexpr size_t HGCD_THRESHOLD = 4096;   // Bits; measured crossover with Lehmer steps
+
+namespace detail {
+
+// Cofactor matrix [[m11, m12], [m21, m22]], determinant 1, non-negative entries
+struct CofactorMatrix {
+    BigInt m11 = 1, m12 = 0, m21 = 0, m22 = 1;
+
+    bool is_identity() const { return m12.is_zero() && m21.is_zero(); }
+
+    // this = this * n
+    void multiply(const CofactorMatrix& n) {
+        BigInt r11 = m11 * n.m11 + m12 * n.m21;
+        BigInt r12 = m11 * n.m12 + m12 * n.m22;
+        BigInt r21 = m21 * n.m11 + m22 * n.m21;
+        BigInt r22 = m21 * n.m12 + m22 * n.m22;
+        m11 = std::move(r11);
+        m12 = std::move(r12);
+        m21 = std::move(r21);
+        m22 = std::move(r22);
+    }
+};
+
+// Same for 64-bit operands (entries stay below 2^32)
+struct WordMatrix {
+    uint64_t m11 = 1, m12 = 0, m21 = 0, m22 = 1;
+};
+
+inline size_t bits_of(uint64_t x) { return x ? 64 - __builtin_clzll(x) : 0; }
+
+// Euclid steps on machine words while both values stay >= 2^s, s = bits/2 + 1:
+// (a, b) = N (a', b') with every entry of N < min(a', b')
+inline WordMatrix hgcd_word(uint64_t a, uint64_t b) {
+    WordMatrix n;
+    size_t s = bits_of(std::max(a, b)) / 2 + 1;
+    uint64_t floor = (uint64_t)1 << s;
+    if (std::min(a, b) < floor) return n;
+
+    for (;;) {
+        if (a >= b) {
+            uint64_t q = a / b, r = a % b;
+            if (r < floor) break;
+            a = r;
+            n.m12 += q * n.m11;   // N * [[1, q], [0, 1]]
+            n.m22 += q * n.m21;
+        } else {
+            uint64_t q = b / a, r = b % a;
+            if (r < floor) break;
+            b = r;
+            n.m11 += q * n.m12;   // N * [[1, 0], [q, 1]]
+            n.m21 += q * n.m22;
+        }
+    }
+    return n;
+}
+
+inline uint64_t binary_gcd(uint64_t a, uint64_t b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b) {
+        b >>= __builtin_ctzll(b);
+        if (a > b) std::swap(a, b);
+        b -= a;
+    }
+    return a << shift;
+}
+
+// Applies a reduction of the top parts (a >> p, b >> p) -> (a0, b0) by n to the
+// full operands: alpha = 2^p a0 + (m22 a1 - m12 b1), beta = 2^p b0 + (m11 b1 - m21 a1)
+inline void lift(const CofactorMatrix& n, const BigInt& a0, const BigInt& b0,
+                 const BigInt& a, const BigInt& b, size_t p, BigInt& alpha, BigInt& beta) {
+    BigInt a1 = a.low_bits(p), b1 = b.low_bits(p);
+    BigInt next_alpha = (a0 << p) + n.m22 * a1;
+    next_alpha -= n.m12 * b1;
+    BigInt next_beta = (b0 << p) + n.m11 * b1;
+    next_beta -= n.m21 * a1;
+    alpha = std::move(next_alpha);
+    beta = std::move(next_beta);
+}
+
+// Top 64 bits of x starting at bit p
+inline uint64_t bits_from(const BigInt& x, size_t p) {
+    return (x.limb(p / 64) >> (p % 64)) | (p % 64 ? x.limb(p / 64 + 1) << (64 - p % 64) : 0);
+}
+
+// One Lehmer step: a 64-bit reduction of the bits above p, lifted. False if the
+// leading words admit no safe quotient.
+inline bool lehmer_step(BigInt& alpha, BigInt& beta, size_t p, CofactorMatrix* m) {
+    uint64_t a0 = bits_from(alpha, p), b0 = bits_from(beta, p);
+    WordMatrix w = hgcd_word(a0, b0);
+    if (w.m12 == 0 && w.m21 == 0) return false;
+
+    CofactorMatrix n;
+    n.m11 = w.m11; n.m12 = w.m12; n.m21 = w.m21; n.m22 = w.m22;
+    uint64_t r0 = w.m22 * a0 - w.m12 * b0;   // Word-level images of the reduced pair
+    uint64_t s0 = w.m11 * b0 - w.m21 * a0;
+    BigInt base_alpha = alpha, base_beta = beta;
+    lift(n, r0, s0, base_alpha, base_beta, p, alpha, beta);
+    if (m) m->multiply(n);
+    return true;
+}
+
+// One plain division step, kept only if the remainder stays above 2^s
+inline bool division_step(BigInt& alpha, BigInt& beta, size_t s, CofactorMatrix& m) {
+    bool alpha_larger = alpha >= beta;
+    const BigInt& big = alpha_larger ? alpha : beta;
+    const BigInt& small = alpha_larger ? beta : alpha;
+    BigInt q = big / small;
+    BigInt r = big - q * small;
+    if (r.bit_length() <= s) return false;
+
+    CofactorMatrix step;
+    if (alpha_larger) {
+        step.m12 = std::move(q);
+        alpha = std::move(r);
+    } else {
+        step.m21 = std::move(q);
+        beta = std::move(r);
+    }
+    m.multiply(step);
+    return true;
+}
+
+// Reduces (alpha, beta) while both stay >= 2^s, accumulating into m
+inline void hgcd_finish(BigInt& alpha, BigInt& beta, size_t s, CofactorMatrix& m) {
+    for (;;) {
+        size_t nb = std::max(alpha.bit_length(), beta.bit_length());
+        size_t p = std::max<size_t>(nb > 62 ? nb - 62 : 0, 2 * s + 1 > nb ? 2 * s + 1 - nb : 0);
+        if (p < nb && lehmer_step(alpha, beta, p, &m)) continue;
+        if (!division_step(alpha, beta, s, m)) return;
+    }
+}
+
+// Half-GCD: (a, b) = m (alpha, beta) with alpha, beta >= 2^s, s = bits/2 + 1,
+// and every entry of m below min(alpha, beta)
+inline void hgcd(const BigInt& a, const BigInt& b, CofactorMatrix& m, BigInt& alpha, BigInt& beta) {
+    size_t n = std::max(a.bit_length(), b.bit_length());
+    size_t s = n / 2 + 1;
+    m = CofactorMatrix();
+    alpha = a;
+    beta = b;
+    if (std::min(a.bit_length(), b.bit_length()) <= s) return;
+
+    if (n > HGCD_THRESHOLD) {
+        // Top halves first: leaves both values around 3n/4 bits
+        size_t p1 = n / 2;
+        CofactorMatrix m1;
+        BigInt a0, b0;
+        hgcd(a >> p1, b >> p1, m1, a0, b0);
+        if (!m1.is_identity()) {
+            lift(m1, a0, b0, a, b, p1, alpha, beta);
+            m = std::move(m1);
+        }
+
+        // One division step brings the larger value down next to the smaller
+        // (both around 3n/4 bits), then the top of what is left, aimed so its
+        // floor lands on 2^s
+        if (std::min(alpha.bit_length(), beta.bit_length()) > s && division_step(alpha, beta, s, m)) {
+            size_t n2 = std::max(alpha.bit_length(), beta.bit_length());
+            size_t p2 = 2 * s + 1 > n2 ? 2 * s + 1 - n2 : 0;
+            if (n2 > p2 && n2 - p2 < n) {
+                CofactorMatrix m2;
+                BigInt a2, b2;
+                hgcd(alpha >> p2, beta >> p2, m2, a2, b2);
+                if (!m2.is_identity()) {
+                    BigInt full_alpha = alpha, full_beta = beta;
+                    lift(m2, a2, b2, full_alpha, full_beta, p2, alpha, beta);
+                    m.multiply(m2);
+                }
+            }
+        }
+    }
+    hgcd_finish(alpha, beta, s, m);
+}
+
+} // namespace detail
+
+// Lehmer GCD: quadratic, but with small constants below HGCD_THRESHOLD
+inline BigInt lehmer_gcd(BigInt a, BigInt b) {
+    while (!a.is_zero() && !b.is_zero()) {
+        size_t nb = std::max(a.bit_length(), b.bit_length());
+        if (nb <= 64) return detail::binary_gcd(a.low64(), b.low64());
+        if (detail::lehmer_step(a, b, nb - 62, nullptr)) continue;
+        if (a >= b) a %= b;
+        else b %= a;
+    }
+    return a.is_zero() ? b : a;
+}
+
+inline BigInt gcd(BigInt a, BigInt b) {
+    detail::CofactorMatrix m;
+    BigInt alpha, beta;
+    while (!a.is_zero() && !b.is_zero()) {
+        size_t lo = std::min(a.bit_length(), b.bit_length());
+        size_t hi = std::max(a.bit_length(), b.bit_length());
+        if (lo <= HGCD_THRESHOLD) return lehmer_gcd(std::move(a), std::move(b));
+
+        // Lopsided operands: one division brings them to the same size
+        if (lo <= hi / 2 + 1) {
+            if (a >= b) a %= b;
+            else b %= a;
+            continue;
+        }
+
+        detail::hgcd(a, b, m, alpha, beta);
+        if (m.is_identity()) {
+            if (a >= b) a %= b;
+            else b %= a;
+        } else {
+            a = std::move(alpha);
+            b = std::move(beta);
+        }
+    }
+    return a.is_zero() ? b : a;
+}
+
+} // namespace bigint
@@ -0,0 +1,219 @@
+/*
+🧱 PER-CONNECTION ARENAS AND SLAB POOLS 🧱
+Memory for the HTTP path that stays off the global heap once warm, so the web
+server never contends with the compute threads for the allocator.
+
+- RequestArena: bump allocator owned by one pooled connection. Everything a
+  request builds (JSON, headers, file bodies) comes from it and is dropped at
+  once by reset() after the response is sent. Blocks past the first are kept,
+  so after a connection has served its largest response it never allocates
+- ArenaBuffer: growable byte buffer in an arena with the stream-style <<
+  used by the JSON writers (doubles print like std::ostream's default)
+- SlabPool<T>: fixed objects (connections with their arenas and I/O buffers)
+  carved from slabs and recycled through a free list
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class RequestArena {
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t used = 0;
+    uint64_t heap_blocks = 0;   // Blocks ever taken from the heap
+
+    void add_block(size_t size) {
+        blocks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+        heap_blocks++;
+    }
+
+public:
+    explicit RequestArena(size_t first_block = 64 * 1024) {
+        blocks.reserve(16);
+        add_block(first_block);
+    }
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    void* allocate(size_t n, size_t align = alignof(std::max_align_t)) {
+        for (;;) {
+            size_t offset = (used + align - 1) & ~(align - 1);
+            if (offset + n <= blocks[current].size) {
+                used = offset + n;
+                return blocks[current].data.get() + offset;
+            }
+            if (current + 1 < blocks.size()) {
+                current++;
+                used = 0;
+                continue;
+            }
+            add_block(std::max(n + align, 2 * blocks.back().size));
+            current = blocks.size() - 1;
+            used = 0;
+        }
+    }
+
+    // Grows the latest allocation in place when nothing was allocated after it
+    bool extend(void* p, size_t old_size, size_t new_size) {
+        char* top = blocks[current].data.get() + used;
+        if (static_cast<char*>(p) + old_size != top) return false;
+        size_t start = used - old_size;
+        if (start + new_size > blocks[current].size) return false;
+        used = start + new_size;
+        return true;
+    }
+
+    // Everything allocated so far is released at once
+    void reset() {
+        current = 0;
+        used = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks) total += b.size;
+        return total;
+    }
+
+    uint64_t heap_allocations() const { return heap_blocks; }
+};
+
+class ArenaBuffer {
+private:
+    RequestArena* arena;
+    char* bytes = nullptr;
+    size_t length = 0;
+    size_t room = 0;
+
+public:
+    explicit ArenaBuffer(RequestArena& a, size_t initial = 0) : arena(&a) { reserve(initial); }
+
+    void reserve(size_t n) {
+        if (n <= room) return;
+        size_t grown = std::max({n, 2 * room, (size_t)256});
+        if (bytes && arena->extend(bytes, room, grown)) {
+            room = grown;
+            return;
+        }
+        char* fresh = static_cast<char*>(arena->allocate(grown, 16));
+        if (length) std::memcpy(fresh, bytes, length);
+        bytes = fresh;
+        room = grown;
+    }
+
+    // Room for n more bytes written directly (e.g. by read()); commit() what was used
+    char* tail(size_t n) {
+        reserve(length + n);
+        return bytes + length;
+    }
+    void commit(size_t n) { length += n; }
+
+    void append(const char* s, size_t n) {
+        std::memcpy(tail(n), s, n);
+        length += n;
+    }
+    void append(std::string_view s) { append(s.data(), s.size()); }
+
+    void resize(size_t n) {
+        reserve(n);
+        length = n;
+    }
+
+    char* data() { return bytes; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(bytes, length); }
+
+    // NUL-terminated view for C APIs
+    const char* c_str() {
+        reserve(length + 1);
+        bytes[length] = '\0';
+        return bytes;
+    }
+
+    ArenaBuffer& operator<<(std::string_view s) { append(s); return *this; }
+    ArenaBuffer& operator<<(const char* s) { append(s, std::strlen(s)); return *this; }
+    ArenaBuffer& operator<<(const std::string& s) { append(s.data(), s.size()); return *this; }
+    ArenaBuffer& operator<<(char c) { append(&c, 1); return *this; }
+    ArenaBuffer& operator<<(int v) { return write_integer(v); }
+    ArenaBuffer& operator<<(unsigned v) { return write_integer(v); }
+    ArenaBuffer& operator<<(long v) { return write_integer(v); }
+    ArenaBuffer& operator<<(unsigned long v) { return write_integer(v); }
+    ArenaBuffer& operator<<(long long v) { return write_integer(v); }
+    ArenaBuffer& operator<<(unsigned long long v) { return write_integer(v); }
+    ArenaBuffer& operator<<(double v) {
+        char text[32];
+        int n = std::snprintf(text, sizeof(text), "%g", v);
+        append(text, (size_t)std::max(n, 0));
+        return *this;
+    }
+
+private:
+    template <typename T>
+    ArenaBuffer& write_integer(T v) {
+        char text[24];
+        auto result = std::to_chars(text, text + sizeof(text), v);
+        append(text, (size_t)(result.ptr - text));
+        return *this;
+    }
+};
+
+template <typename T, size_t PER_SLAB = 16>
+class SlabPool {
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<T[]>> slabs;
+    std::vector<T*> free_list;
+
+public:
+    explicit SlabPool(size_t prefill = PER_SLAB) {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (slabs.size() * PER_SLAB < prefill) add_slab();
+    }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // A recycled object in whatever state release() left it
+    T* acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_list.empty()) add_slab();
+        T* object = free_list.back();
+        free_list.pop_back();
+        return object;
+    }
+
+    void release(T* object) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_list.push_back(object);   // Capacity reserved by add_slab: never allocates
+    }
+
+    size_t capacity() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return slabs.size() * PER_SLAB;
+    }
+
+private:
+    void add_slab() {
+        slabs.emplace_back(new T[PER_SLAB]);
+        free_list.reserve(slabs.size() * PER_SLAB);
+        for (size_t i = 0; i < PER_SLAB; i++) free_list.push_back(&slabs.back()[i]);
+    }
+};
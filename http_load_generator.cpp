@@ -0,0 +1,568 @@
+/*
+🌊 HTTP LOAD GENERATOR 🌊
+Drives the C++ system's HTTPServer with a replayable request mix and reports
+throughput, errors and latency percentiles - numbers to compare before and
+after every server change.
+
+- One epoll loop over many non-blocking keep-alive connections (reconnects
+  when the server closes one)
+- Closed loop: every connection sends its next request as soon as the last
+  one answers. Open loop: requests fire at a constant rate whether or not the
+  server keeps up, and latency counts from the scheduled send time, so a
+  stalled server is not hidden by coordinated omission
+- Mix of GET /, /api/status, /api/progress, /api/test_mersenne?p=... (p from
+  a chosen distribution), static assets and the research PDF
+- Log-linear latency histograms (1 us resolution, ~1.5% relative error) per
+  endpoint and overall: p50 / p90 / p99 / p999 / max
+
+Interference: the server runs its discovery engine in the background unless
+started with MERSENNE_DISCOVERY=0, so run once each way and compare.
+
+Usage: http_load_generator [--host 127.0.0.1] [--port 8081] [--connections 32]
+         [--duration 10] [--warmup 2] [--mode closed|open] [--rate 1000]
+         [--mix root=1,status=4,progress=2,test=2,asset=1,pdf=0.1]
+         [--p-dist uniform:3:10000|loguniform:3:100000|list:31,61,89]
+         [--timeout 5] [--label name] [--csv results.csv] [--seed 1]
+*/
+
+#if !defined(__linux__)
+#error "http_load_generator is epoll-based and builds on Linux only"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// ========================================
+// LATENCY HISTOGRAM
+// ========================================
+
+// Log-linear buckets over microseconds: 64 linear sub-buckets per power of two
+class LatencyHistogram {
+private:
+    static constexpr int SUB_BITS = 6;
+    static constexpr int SUB = 1 << SUB_BITS;
+    static constexpr int RANGES = 40;   // Up to 2^40 us
+    vector<uint64_t> counts = vector<uint64_t>(RANGES * SUB, 0);
+    uint64_t total = 0;
+    uint64_t max_us = 0;
+    double sum_us = 0;
+
+    static size_t index_of(uint64_t us) {
+        if (us < SUB) return (size_t)us;
+        int range = 63 - __builtin_clzll(us) - SUB_BITS + 1;
+        return (size_t)range * SUB + (size_t)((us >> (range - 1)) - SUB);
+    }
+
+    static uint64_t value_at(size_t index) {
+        size_t range = index / SUB, sub = index % SUB;
+        if (range == 0) return sub;
+        return (uint64_t)(SUB + sub) << (range - 1);
+    }
+
+public:
+    void record(uint64_t us) {
+        size_t i = min(index_of(us), counts.size() - 1);
+        counts[i]++;
+        total++;
+        max_us = std::max(max_us, us);
+        sum_us += (double)us;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max_value() const { return max_us; }
+    double mean() const { return total ? sum_us / total : 0.0; }
+
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)ceil(q * total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(value_at(i), max_us);
+        }
+        return max_us;
+    }
+};
+
+// ========================================
+// REQUEST MIX
+// ========================================
+
+struct Endpoint {
+    string name;
+    double weight;
+};
+
+class RequestMix {
+private:
+    vector<Endpoint> endpoints;
+    discrete_distribution<size_t> pick;
+    string p_dist = "loguniform:3:100000";
+    vector<uint64_t> p_list;
+    uint64_t p_lo = 3, p_hi = 100000;
+    mt19937_64 rng;
+
+    static bool is_prime(uint64_t n) {
+        if (n < 2) return false;
+        for (uint64_t d = 2; d * d <= n; d++) {
+            if (n % d == 0) return false;
+        }
+        return true;
+    }
+
+    uint64_t next_p() {
+        if (!p_list.empty()) return p_list[rng() % p_list.size()];
+        uint64_t p;
+        if (p_dist.rfind("uniform", 0) == 0) {
+            p = uniform_int_distribution<uint64_t>(p_lo, p_hi)(rng);
+        } else {
+            double x = uniform_real_distribution<double>(log((double)p_lo), log((double)p_hi))(rng);
+            p = (uint64_t)exp(x);
+        }
+        while (!is_prime(p)) p++;   // The API tests prime exponents
+        return p;
+    }
+
+public:
+    RequestMix(const string& mix, const string& distribution, uint64_t seed) : p_dist(distribution), rng(seed) {
+        stringstream in(mix);
+        string item;
+        vector<double> weights;
+        while (getline(in, item, ',')) {
+            size_t eq = item.find('=');
+            string name = item.substr(0, eq);
+            double weight = eq == string::npos ? 1.0 : atof(item.c_str() + eq + 1);
+            if (name != "root" && name != "status" && name != "progress" && name != "test" && name != "asset" && name != "pdf") {
+                throw invalid_argument("unknown endpoint in --mix: " + name);
+            }
+            if (weight > 0) {
+                endpoints.push_back({name, weight});
+                weights.push_back(weight);
+            }
+        }
+        if (endpoints.empty()) throw invalid_argument("--mix selects no endpoint");
+        pick = discrete_distribution<size_t>(weights.begin(), weights.end());
+
+        stringstream d(distribution);
+        string kind, a, b;
+        getline(d, kind, ':');
+        if (kind == "list") {
+            while (getline(d, a, ',')) p_list.push_back(strtoull(a.c_str(), nullptr, 10));
+            if (p_list.empty()) throw invalid_argument("--p-dist list is empty");
+        } else if (kind == "uniform" || kind == "loguniform") {
+            getline(d, a, ':');
+            getline(d, b, ':');
+            p_lo = max<uint64_t>(2, strtoull(a.c_str(), nullptr, 10));
+            p_hi = max<uint64_t>(p_lo, strtoull(b.c_str(), nullptr, 10));
+        } else {
+            throw invalid_argument("unknown --p-dist: " + distribution);
+        }
+    }
+
+    const vector<Endpoint>& all() const { return endpoints; }
+
+    // Endpoint index and the request line's target
+    pair<size_t, string> next() {
+        size_t i = pick(rng);
+        const string& name = endpoints[i].name;
+        if (name == "root") return {i, "/"};
+        if (name == "status") return {i, "/api/status"};
+        if (name == "progress") return {i, "/api/progress"};
+        if (name == "test") return {i, "/api/test_mersenne?p=" + to_string(next_p())};
+        if (name == "asset") return {i, (rng() & 1) ? "/assets/background.jpg" : "/assets/images.jpg"};
+        return {i, "/research-paper"};
+    }
+};
+
+// ========================================
+// CONNECTIONS
+// ========================================
+
+struct Connection {
+    int fd = -1;
+    bool connecting = false;
+    bool busy = false;
+    string out;                 // Unsent request bytes
+    size_t out_offset = 0;
+    string in;                  // Response bytes so far
+    size_t header_end = 0;      // 0 until the header block is complete
+    long long content_length = -1;
+    int status = 0;
+    size_t endpoint = 0;
+    Clock::time_point started;  // Scheduled (open loop) or actual send time
+};
+
+struct Stats {
+    vector<LatencyHistogram> per_endpoint;
+    LatencyHistogram overall;
+    vector<uint64_t> errors;    // Per endpoint: connect/reset/timeout/non-2xx
+    uint64_t bytes = 0, completed = 0, failed = 0, reconnects = 0, dropped = 0;
+};
+
+class LoadGenerator {
+public:
+    struct Options {
+        string host = "127.0.0.1";
+        int port = 8081;
+        int connections = 32;
+        double duration = 10, warmup = 2, rate = 1000, timeout = 5;
+        bool open_loop = false;
+        string mix = "root=1,status=4,progress=2,test=2,asset=1,pdf=0.1";
+        string p_dist = "loguniform:3:100000";
+        string label = "run";
+        string csv;
+        uint64_t seed = 1;
+    };
+
+private:
+    Options opt;
+    RequestMix mix;
+    sockaddr_in address{};
+    int epoll_fd = -1;
+    vector<Connection> conns;
+    Stats stats;
+    bool measuring = false;
+    deque<Clock::time_point> backlog;   // Open loop: scheduled sends waiting for a free connection
+
+    void connect_slot(size_t i) {
+        Connection& c = conns[i];
+        if (c.fd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+            close(c.fd);
+        }
+        c = Connection();
+        c.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (c.fd < 0) throw runtime_error(string("socket: ") + strerror(errno));
+        int one = 1;
+        setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        int rc = ::connect(c.fd, (sockaddr*)&address, sizeof(address));
+        c.connecting = rc < 0 && errno == EINPROGRESS;
+        if (rc < 0 && errno != EINPROGRESS) {
+            close(c.fd);
+            c.fd = -1;
+            return;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+        ev.data.u64 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c.fd, &ev);
+    }
+
+    void watch(size_t i, bool want_write) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | (want_write ? (uint32_t)EPOLLOUT : 0u);
+        ev.data.u64 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conns[i].fd, &ev);
+    }
+
+    void send_request(size_t i, Clock::time_point scheduled) {
+        Connection& c = conns[i];
+        if (c.fd < 0) {
+            connect_slot(i);
+            stats.reconnects++;
+        }
+        auto [endpoint, target] = mix.next();
+        c.busy = true;
+        c.endpoint = endpoint;
+        c.started = scheduled;
+        c.in.clear();
+        c.header_end = 0;
+        c.content_length = -1;
+        c.status = 0;
+        c.out = "GET " + target + " HTTP/1.1\r\nHost: " + opt.host + "\r\nConnection: keep-alive\r\n\r\n";
+        c.out_offset = 0;
+        if (c.fd < 0) {
+            fail(i);
+            return;
+        }
+        if (!c.connecting) flush(i);
+    }
+
+    void flush(size_t i) {
+        Connection& c = conns[i];
+        while (c.out_offset < c.out.size()) {
+            ssize_t n = ::send(c.fd, c.out.data() + c.out_offset, c.out.size() - c.out_offset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN) break;
+                fail(i);
+                return;
+            }
+            c.out_offset += (size_t)n;
+        }
+        watch(i, c.out_offset < c.out.size());
+    }
+
+    void finish(size_t i, bool ok) {
+        Connection& c = conns[i];
+        uint64_t us = (uint64_t)chrono::duration_cast<chrono::microseconds>(Clock::now() - c.started).count();
+        if (measuring) {
+            if (ok) {
+                stats.per_endpoint[c.endpoint].record(us);
+                stats.overall.record(us);
+                stats.completed++;
+                stats.bytes += c.in.size();
+            } else {
+                stats.errors[c.endpoint]++;
+                stats.failed++;
+            }
+        }
+        c.busy = false;
+    }
+
+    void fail(size_t i) {
+        Connection& c = conns[i];
+        if (c.busy) finish(i, false);
+        if (c.fd >= 0) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+            close(c.fd);
+        }
+        c.fd = -1;
+    }
+
+    // Parses what has arrived; true once the response is complete
+    bool response_complete(Connection& c, bool eof) {
+        if (c.header_end == 0) {
+            size_t end = c.in.find("\r\n\r\n");
+            if (end == string::npos) return false;
+            c.header_end = end + 4;
+            c.status = c.in.size() > 12 ? atoi(c.in.c_str() + 9) : 0;
+            string headers = c.in.substr(0, c.header_end);
+            transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+            size_t cl = headers.find("content-length:");
+            if (cl != string::npos) c.content_length = atoll(headers.c_str() + cl + 15);
+        }
+        if (c.content_length >= 0) return c.in.size() >= c.header_end + (size_t)c.content_length;
+        return eof;   // No length: the body ends at close
+    }
+
+    void on_readable(size_t i) {
+        Connection& c = conns[i];
+        char buffer[65536];
+        bool eof = false;
+        for (;;) {
+            ssize_t n = ::recv(c.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                if (c.busy) c.in.append(buffer, (size_t)n);
+                continue;
+            }
+            if (n == 0) eof = true;
+            else if (errno != EAGAIN) eof = true;
+            break;
+        }
+
+        if (c.busy && c.out_offset == c.out.size() && response_complete(c, eof)) {
+            finish(i, c.status >= 200 && c.status < 300);
+            if (eof) fail(i);   // Server closed after answering: reconnect on next send
+            return;
+        }
+        if (eof) fail(i);
+    }
+
+    void on_event(size_t i, uint32_t events) {
+        Connection& c = conns[i];
+        if (c.fd < 0) return;
+        if (c.connecting && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(c.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0) {
+                fail(i);
+                return;
+            }
+            c.connecting = false;
+            if (c.busy) flush(i);
+            else watch(i, false);
+        } else if (events & EPOLLOUT) {
+            flush(i);
+        }
+        if (c.fd >= 0 && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) on_readable(i);
+    }
+
+    void expire(Clock::time_point now) {
+        auto limit = chrono::duration<double>(opt.timeout);
+        for (size_t i = 0; i < conns.size(); i++) {
+            if (conns[i].busy && now - conns[i].started > limit) fail(i);
+        }
+    }
+
+    int idle_connection() {
+        for (size_t i = 0; i < conns.size(); i++) {
+            if (!conns[i].busy) return (int)i;
+        }
+        return -1;
+    }
+
+public:
+    explicit LoadGenerator(const Options& o) : opt(o), mix(o.mix, o.p_dist, o.seed) {
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)opt.port);
+        if (inet_pton(AF_INET, opt.host.c_str(), &address.sin_addr) != 1) {
+            addrinfo hints{}, *found = nullptr;
+            hints.ai_family = AF_INET;
+            if (getaddrinfo(opt.host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+                throw runtime_error("cannot resolve " + opt.host);
+            }
+            address.sin_addr = ((sockaddr_in*)found->ai_addr)->sin_addr;
+            freeaddrinfo(found);
+        }
+        stats.per_endpoint.resize(mix.all().size());
+        stats.errors.assign(mix.all().size(), 0);
+    }
+
+    ~LoadGenerator() {
+        for (Connection& c : conns) {
+            if (c.fd >= 0) close(c.fd);
+        }
+        if (epoll_fd >= 0) close(epoll_fd);
+    }
+
+    void run() {
+        epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0) throw runtime_error(string("epoll_create1: ") + strerror(errno));
+        conns.resize((size_t)max(1, opt.connections));
+        for (size_t i = 0; i < conns.size(); i++) connect_slot(i);
+
+        auto start = Clock::now();
+        auto measure_from = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(opt.warmup));
+        auto stop = measure_from + chrono::duration_cast<Clock::duration>(chrono::duration<double>(opt.duration));
+        auto interval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / max(opt.rate, 1e-3)));
+        auto next_send = start;
+
+        vector<epoll_event> events(conns.size());
+        for (;;) {
+            auto now = Clock::now();
+            measuring = now >= measure_from && now < stop;
+            if (now >= stop) break;
+
+            if (opt.open_loop) {
+                // Every due send is queued at its scheduled time, then handed to idle connections
+                while (next_send <= now) {
+                    backlog.push_back(next_send);
+                    next_send += interval;
+                }
+                int idle;
+                while (!backlog.empty() && (idle = idle_connection()) >= 0) {
+                    send_request((size_t)idle, backlog.front());
+                    backlog.pop_front();
+                }
+            } else {
+                for (size_t i = 0; i < conns.size(); i++) {
+                    if (!conns[i].busy) send_request(i, now);
+                }
+            }
+
+            int wait_ms = 10;
+            if (opt.open_loop) {
+                auto until = chrono::duration_cast<chrono::milliseconds>(next_send - Clock::now()).count();
+                wait_ms = (int)max<long long>(0, min<long long>(wait_ms, until));
+            }
+            int n = epoll_wait(epoll_fd, events.data(), (int)events.size(), wait_ms);
+            for (int e = 0; e < n; e++) on_event((size_t)events[e].data.u64, events[e].events);
+            expire(Clock::now());
+        }
+        stats.dropped = backlog.size();
+    }
+
+    void report() const {
+        double seconds = opt.duration;
+        cout << "========================================" << endl;
+        cout << "🌊 " << opt.label << ": " << (opt.open_loop ? "open loop @ " + to_string((int)opt.rate) + " req/s" : string("closed loop"))
+             << ", " << opt.connections << " connections, " << opt.duration << " s" << endl;
+        cout << fixed << setprecision(1);
+        cout << "Throughput: " << stats.completed / seconds << " req/s, "
+             << stats.bytes / seconds / (1024 * 1024) << " MB/s" << endl;
+        cout << "Errors: " << stats.failed << " (" << setprecision(3)
+             << (stats.completed + stats.failed ? 100.0 * stats.failed / (stats.completed + stats.failed) : 0.0)
+             << "%), reconnects " << stats.reconnects << ", unsent backlog " << stats.dropped << endl;
+
+        cout << left << setw(10) << "endpoint" << right << setw(10) << "count" << setw(8) << "errors"
+             << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms" << setw(10) << "p999 ms"
+             << setw(10) << "max ms" << endl;
+        auto row = [](const string& name, const LatencyHistogram& h, uint64_t errors) {
+            cout << left << setw(10) << name << right << setw(10) << h.count() << setw(8) << errors << setprecision(3)
+                 << setw(10) << h.percentile(0.50) / 1000.0 << setw(10) << h.percentile(0.90) / 1000.0
+                 << setw(10) << h.percentile(0.99) / 1000.0 << setw(10) << h.percentile(0.999) / 1000.0
+                 << setw(10) << h.max_value() / 1000.0 << endl;
+        };
+        for (size_t i = 0; i < mix.all().size(); i++) row(mix.all()[i].name, stats.per_endpoint[i], stats.errors[i]);
+        row("all", stats.overall, stats.failed);
+    }
+
+    // One line per run, so before/after runs land in the same file
+    void append_csv() const {
+        if (opt.csv.empty()) return;
+        bool fresh = !ifstream(opt.csv).good();
+        ofstream out(opt.csv, ios::app);
+        if (fresh) out << "label,mode,connections,rate,duration,req_per_s,errors,p50_ms,p90_ms,p99_ms,p999_ms,max_ms\n";
+        out << opt.label << ',' << (opt.open_loop ? "open" : "closed") << ',' << opt.connections << ','
+            << opt.rate << ',' << opt.duration << ',' << stats.completed / opt.duration << ',' << stats.failed << ','
+            << stats.overall.percentile(0.50) / 1000.0 << ',' << stats.overall.percentile(0.90) / 1000.0 << ','
+            << stats.overall.percentile(0.99) / 1000.0 << ',' << stats.overall.percentile(0.999) / 1000.0 << ','
+            << stats.overall.max_value() / 1000.0 << '\n';
+    }
+};
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+    signal(SIGPIPE, SIG_IGN);
+
+    LoadGenerator::Options opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string key = argv[i], value = argv[i + 1];
+        if (key == "--host") opt.host = value;
+        else if (key == "--port") opt.port = atoi(value.c_str());
+        else if (key == "--connections") opt.connections = atoi(value.c_str());
+        else if (key == "--duration") opt.duration = atof(value.c_str());
+        else if (key == "--warmup") opt.warmup = atof(value.c_str());
+        else if (key == "--mode") opt.open_loop = value == "open";
+        else if (key == "--rate") opt.rate = atof(value.c_str());
+        else if (key == "--mix") opt.mix = value;
+        else if (key == "--p-dist") opt.p_dist = value;
+        else if (key == "--timeout") opt.timeout = atof(value.c_str());
+        else if (key == "--label") opt.label = value;
+        else if (key == "--csv") opt.csv = value;
+        else if (key == "--seed") opt.seed = strtoull(value.c_str(), nullptr, 10);
+        else {
+            cerr << "Unknown option " << key << endl;
+            return 1;
+        }
+    }
+
+    try {
+        LoadGenerator generator(opt);
+        cout << "🌊 Loading http://" << opt.host << ":" << opt.port << " (" << opt.warmup << " s warm-up)" << endl;
+        generator.run();
+        generator.report();
+        generator.append_csv();
+    } catch (const exception& e) {
+        cerr << "❌ " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
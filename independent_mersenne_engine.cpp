@@ -16,209 +16,13 @@ Complete C++ implementation with FFT, no GIMPS dependencies
 #include <random>
 #include <iomanip>
 
+#include "trace_recorder.h"
+#include "sampling_profiler.h"
+#include "big_int.h"
+
 using namespace std;
 using namespace chrono;
 
-class FFTMultiplier {
-private:
-    static constexpr double PI = 3.14159265358979323846;
-    
-    void fft(vector<complex<double>>& a, bool invert) {
-        int n = a.size();
-        
-        // Bit-reversal permutation
-        for (int i = 1, j = 0; i < n; i++) {
-            int bit = n >> 1;
-            for (; j & bit; bit >>= 1) j ^= bit;
-            j ^= bit;
-            if (i < j) swap(a[i], a[j]);
-        }
-        
-        // FFT computation
-        for (int len = 2; len <= n; len <<= 1) {
-            double ang = 2 * PI / len * (invert ? -1 : 1);
-            complex<double> wlen(cos(ang), sin(ang));
-            
-            for (int i = 0; i < n; i += len) {
-                complex<double> w(1);
-                for (int j = 0; j < len / 2; j++) {
-                    complex<double> u = a[i + j];
-                    complex<double> v = a[i + j + len / 2] * w;
-                    a[i + j] = u + v;
-                    a[i + j + len / 2] = u - v;
-                    w *= wlen;
-                }
-            }
-        }
-        
-        if (invert) {
-            for (auto& x : a) x /= n;
-        }
-    }
-    
-public:
-    vector<uint64_t> multiply(const vector<uint64_t>& a, const vector<uint64_t>& b) {
-        int result_size = a.size() + b.size();
-        int n = 1;
-        while (n < result_size) n <<= 1;
-        
-        vector<complex<double>> fa(a.begin(), a.end()), fb(b.begin(), b.end());
-        fa.resize(n); fb.resize(n);
-        
-        fft(fa, false); fft(fb, false);
-        for (int i = 0; i < n; i++) fa[i] *= fb[i];
-        fft(fa, true);
-        
-        vector<uint64_t> result(n);
-        uint64_t carry = 0;
-        for (int i = 0; i < n; i++) {
-            uint64_t val = round(fa[i].real()) + carry;
-            result[i] = val % 1000000000ULL; // Base 10^9
-            carry = val / 1000000000ULL;
-        }
-        
-        while (result.size() > 1 && result.back() == 0) result.pop_back();
-        return result;
-    }
-};
-
-class BigInteger {
-private:
-    vector<uint64_t> digits; // Base 10^9
-    static constexpr uint64_t BASE = 1000000000ULL;
-    FFTMultiplier fft_mult;
-    
-public:
-    BigInteger(uint64_t n = 0) {
-        if (n == 0) {
-            digits = {0};
-        } else {
-            while (n > 0) {
-                digits.push_back(n % BASE);
-                n /= BASE;
-            }
-        }
-    }
-    
-    BigInteger(const vector<uint64_t>& d) : digits(d) {}
-    
-    BigInteger operator*(const BigInteger& other) const {
-        if (digits.size() + other.digits.size() > 100) {
-            // Use FFT for large numbers
-            return BigInteger(fft_mult.multiply(digits, other.digits));
-        } else {
-            // Use schoolbook for small numbers
-            return schoolbook_multiply(other);
-        }
-    }
-    
-    BigInteger schoolbook_multiply(const BigInteger& other) const {
-        vector<uint64_t> result(digits.size() + other.digits.size(), 0);
-        
-        for (size_t i = 0; i < digits.size(); i++) {
-            uint64_t carry = 0;
-            for (size_t j = 0; j < other.digits.size(); j++) {
-                __uint128_t prod = (__uint128_t)digits[i] * other.digits[j] + result[i + j] + carry;
-                result[i + j] = prod % BASE;
-                carry = prod / BASE;
-            }
-            if (carry) result[i + other.digits.size()] += carry;
-        }
-        
-        while (result.size() > 1 && result.back() == 0) result.pop_back();
-        return BigInteger(result);
-    }
-    
-    BigInteger operator-(uint64_t n) const {
-        vector<uint64_t> result = digits;
-        uint64_t borrow = n;
-        
-        for (size_t i = 0; i < result.size() && borrow > 0; i++) {
-            if (result[i] >= borrow) {
-                result[i] -= borrow;
-                borrow = 0;
-            } else {
-                result[i] = result[i] + BASE - borrow;
-                borrow = 1;
-            }
-        }
-        
-        while (result.size() > 1 && result.back() == 0) result.pop_back();
-        return BigInteger(result);
-    }
-    
-    BigInteger operator%(const BigInteger& mod) const {
-        // Simplified modular reduction using Barrett reduction
-        return barrett_reduce(mod);
-    }
-    
-    BigInteger barrett_reduce(const BigInteger& mod) const {
-        // Simplified Barrett reduction
-        if (compare(mod) < 0) return *this;
-        
-        BigInteger result = *this;
-        while (result.compare(mod) >= 0) {
-            result = result.subtract(mod);
-        }
-        return result;
-    }
-    
-    BigInteger subtract(const BigInteger& other) const {
-        vector<uint64_t> result = digits;
-        uint64_t borrow = 0;
-        
-        for (size_t i = 0; i < max(result.size(), other.digits.size()); i++) {
-            uint64_t sub = borrow;
-            if (i < other.digits.size()) sub += other.digits[i];
-            
-            if (i < result.size() && result[i] >= sub) {
-                result[i] -= sub;
-                borrow = 0;
-            } else {
-                if (i >= result.size()) result.resize(i + 1, 0);
-                result[i] = result[i] + BASE - sub;
-                borrow = 1;
-            }
-        }
-        
-        while (result.size() > 1 && result.back() == 0) result.pop_back();
-        return BigInteger(result);
-    }
-    
-    int compare(const BigInteger& other) const {
-        if (digits.size() != other.digits.size()) {
-            return digits.size() < other.digits.size() ? -1 : 1;
-        }
-        
-        for (int i = digits.size() - 1; i >= 0; i--) {
-            if (digits[i] != other.digits[i]) {
-                return digits[i] < other.digits[i] ? -1 : 1;
-            }
-        }
-        return 0;
-    }
-    
-    bool is_zero() const {
-        return digits.size() == 1 && digits[0] == 0;
-    }
-    
-    static BigInteger power_of_two(int exp) {
-        if (exp <= 63) {
-            return BigInteger(1ULL << exp);
-        }
-        
-        // For large exponents, build iteratively
-        BigInteger result(1);
-        BigInteger two(2);
-        
-        for (int i = 0; i < exp; i++) {
-            result = result * two;
-        }
-        
-        return result;
-    }
-};
-
 class IndependentLucasLehmer {
 public:
     struct TestResult {
@@ -240,8 +44,8 @@ public:
         }
         
         try {
-            BigInteger s(4);
-            BigInteger M = BigInteger::power_of_two(p) - 2; // 2^p - 1
+            BigInt s(4);
+            BigInt M = BigInt::mersenne(p);
             
             for (int i = 0; i < p - 2; i++) {
                 // Check timeout
@@ -252,9 +56,8 @@ public:
                     return {false, elapsed, i, "Timeout exceeded"};
                 }
                 
-                // Core Lucas-Lehmer iteration: s = (s² - 2) mod M
-                s = (s * s) - 2;
-                s = s % M;
+                // Core Lucas-Lehmer iteration: s = (s² - 2) mod M, fused
+                s = (s * s - 2) % M;
                 
                 // Progress reporting
                 if (i % 1000 == 0 && i > 0) {
@@ -363,15 +166,26 @@ public:
         
         for (int t = 0; t < num_threads; t++) {
             threads.emplace_back([&, t]() {
+                TraceRecorder::instance().set_thread_name("ll-worker-" + to_string(t));
+                ProfiledThread profiled;
                 size_t idx;
                 while ((idx = candidate_index.fetch_add(1)) < candidates.size()) {
                     int p = candidates[idx];
+                    TraceRecorder::instance().record_instant("queue_pop", "queue", idx);
                     
                     cout << "Thread " << t << " testing p=" << p << endl;
-                    auto result = ll_tester.lucas_lehmer_test(p, 60.0); // 1 minute timeout
+                    IndependentLucasLehmer::TestResult result;
+                    {
+                        TraceSpan span("ll_test", "discovery", p);
+                        result = ll_tester.lucas_lehmer_test(p, 60.0); // 1 minute timeout
+                    }
                     
                     {
-                        lock_guard<mutex> lock(results_mutex);
+                        unique_lock<mutex> lock(results_mutex, defer_lock);
+                        {
+                            TraceSpan wait("results_mutex_wait", "lock", p);
+                            lock.lock();
+                        }
                         results.push_back({p, result});
                         
                         if (result.is_prime) {
@@ -422,6 +236,7 @@ public:
     
 private:
     void save_discovery(int p, const IndependentLucasLehmer::TestResult& result) {
+        TraceSpan span("save_discovery", "checkpoint", p);
         ofstream file("independent_mersenne_discoveries.txt", ios::app);
         if (file.is_open()) {
             auto now = system_clock::now();
@@ -440,6 +255,7 @@ private:
     }
     
     void save_all_results() {
+        TraceSpan span("save_all_results", "checkpoint");
         ofstream file("independent_test_results.txt");
         if (file.is_open()) {
             file << "Independent Mersenne Prime Engine Results" << endl;
@@ -467,7 +283,9 @@ int main() {
         
         cout << "Hardware threads available: " << threads << endl;
         
+        TraceRecorder::instance().install_signal_dump("independent_trace.json");
         engine.run_discovery(start, end, max_candidates, threads);
+        TraceRecorder::instance().dump_to_file("independent_trace.json");
         
     } catch (const exception& e) {
         cout << "Error: " << e.what() << endl;
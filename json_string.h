@@ -0,0 +1,24 @@
+/*
+🔤 JSON STRING WRITER 🔤
+The one escaper behind every hand-written JSON document (dashboard
+statistics, HTTP error bodies, trace exports).
+
+- write_json_string(out, s): s as a quoted JSON string on any stream-style
+  writer (std::ostream, ArenaBuffer). Quotes and backslashes are escaped;
+  control characters become spaces.
+*/
+
+#pragma once
+
+#include <string_view>
+
+template <typename Out>
+inline void write_json_string(Out& json, std::string_view s) {
+    json << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') json << '\\' << c;
+        else if ((unsigned char)c < 0x20) json << ' ';
+        else json << c;
+    }
+    json << '"';
+}
@@ -0,0 +1,207 @@
+/*
+🔁 MULTI-PRECISION MONTGOMERY ARITHMETIC 🔁
+Modular multiply and exponentiate for any odd modulus on the BigInt limb
+type - P-1 factors, cofactors, and factor checks for q beyond 128 bits.
+
+- Precomputed n' = -n^-1 mod 2^64 and R^2 mod n (R = 2^(64k), k limbs)
+- Products below the Karatsuba threshold use CIOS (interleaved multiply
+  and reduce); larger ones multiply with the BigInt tiers, then SOS-reduce
+- Fixed-window exponentiation, window width picked from the exponent size
+- The raw k-limb API works on caller buffers plus per-thread scratch, so a
+  steady-state loop never allocates
+
+Mersenne moduli do not need any of this: BigInt already reduces by 2^p - 1
+with shift-and-add.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "big_int.h"
+
+namespace bigint {
+
+class Montgomery {
+private:
+    BigInt n;
+    size_t k;                       // Limbs in the modulus
+    limb_t n_prime;                 // -n^-1 mod 2^64
+    std::vector<limb_t> r_squared;  // R^2 mod n
+    std::vector<limb_t> r_one;      // R mod n: 1 in Montgomery form
+
+    // r[0, k) = t[0, k] minus n once if needed (t < 2n)
+    void final_subtract(limb_t* r, const limb_t* t) const {
+        if (t[k] || detail::compare(t, k, n.data(), k) >= 0) {
+            detail::sub_n(r, t, n.data(), k);
+        } else {
+            std::copy(t, t + k, r);
+        }
+    }
+
+    // Coarsely Integrated Operand Scanning: t = a * b * R^-1, one limb of b at a time
+    void mul_cios(limb_t* r, const limb_t* a, const limb_t* b) const {
+        detail::Scratch::Frame frame;
+        limb_t* t = frame.take(k + 2);
+        std::fill(t, t + k + 2, 0);
+        for (size_t i = 0; i < k; i++) {
+            dlimb_t top = (dlimb_t)t[k] + detail::addmul_1(t, a, k, b[i]);
+            t[k] = (limb_t)top;
+            t[k + 1] = (limb_t)(top >> 64);
+
+            limb_t m = t[0] * n_prime;
+            top = (dlimb_t)t[k] + detail::addmul_1(t, n.data(), k, m);
+            t[k] = (limb_t)top;
+            t[k + 1] += (limb_t)(top >> 64);
+
+            std::copy(t + 1, t + k + 2, t);   // t[0] is zero now
+            t[k + 1] = 0;
+        }
+        final_subtract(r, t);
+    }
+
+public:
+    explicit Montgomery(const BigInt& modulus) : n(modulus), k(modulus.size()) {
+        if (!n.is_odd()) throw std::invalid_argument("Montgomery: modulus must be odd");
+
+        n_prime = kernel_body::mont_neg_inverse(n.low64());
+        BigInt r = BigInt::power_of_two(64 * k) % n;
+        BigInt r2 = BigInt::power_of_two(128 * k) % n;
+        r_one.assign(k, 0);
+        r_squared.assign(k, 0);
+        std::copy(r.data(), r.data() + r.size(), r_one.begin());
+        std::copy(r2.data(), r2.data() + r2.size(), r_squared.begin());
+    }
+
+    const BigInt& modulus() const { return n; }
+    size_t limbs() const { return k; }
+
+    // ========================================
+    // RAW K-LIMB API (Montgomery form, r may alias a or b)
+    // ========================================
+
+    // Separated Operand Scanning reduction: r = t * R^-1 mod n for t < n * R.
+    // t holds 2k limbs and is used as workspace.
+    void reduce(limb_t* r, limb_t* t) const {
+        detail::Scratch::Frame frame;
+        limb_t* w = frame.take(2 * k + 1);
+        std::copy(t, t + 2 * k, w);
+        w[2 * k] = 0;
+        for (size_t i = 0; i < k; i++) {
+            limb_t m = w[i] * n_prime;
+            limb_t carry = detail::addmul_1(w + i, n.data(), k, m);
+            for (size_t j = i + k; carry; j++) {
+                w[j] += carry;
+                carry = w[j] < carry;
+            }
+        }
+        final_subtract(r, w + k);
+    }
+
+    void mul(limb_t* r, const limb_t* a, const limb_t* b) const {
+        if (k < KARATSUBA_THRESHOLD) {
+            mul_cios(r, a, b);
+            return;
+        }
+        detail::Scratch::Frame frame;
+        limb_t* t = frame.take(2 * k);
+        detail::mul(t, a, k, b, k);
+        reduce(r, t);
+    }
+
+    void to_montgomery(limb_t* r, const limb_t* a) const { mul(r, a, r_squared.data()); }
+
+    void from_montgomery(limb_t* r, const limb_t* a) const {
+        detail::Scratch::Frame frame;
+        limb_t* t = frame.take(2 * k);
+        std::copy(a, a + k, t);
+        std::fill(t + k, t + 2 * k, 0);
+        reduce(r, t);
+    }
+
+    // r = base^exponent, both in Montgomery form
+    void pow(limb_t* r, const limb_t* base, const BigInt& exponent) const {
+        size_t bits = exponent.bit_length();
+        if (bits == 0) {
+            std::copy(r_one.begin(), r_one.end(), r);
+            return;
+        }
+
+        // Window width that minimizes 2^w table muls + bits/w window muls
+        unsigned w = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 6 ? 2 : 1;
+        detail::Scratch::Frame frame;
+        limb_t* table = frame.take(k << w);
+        std::copy(r_one.begin(), r_one.end(), table);
+        for (size_t j = 1; j < ((size_t)1 << w); j++) mul(table + j * k, table + (j - 1) * k, base);
+
+        limb_t* acc = frame.take(k);
+        std::copy(r_one.begin(), r_one.end(), acc);
+        size_t windows = (bits + w - 1) / w;
+        for (size_t win = windows; win-- > 0;) {
+            if (win + 1 != windows) {
+                for (unsigned s = 0; s < w; s++) mul(acc, acc, acc);
+            }
+            size_t digit = 0;
+            for (unsigned s = w; s-- > 0;) digit = (digit << 1) | exponent.bit(win * w + s);
+            if (digit) mul(acc, acc, table + digit * k);
+        }
+        std::copy(acc, acc + k, r);
+    }
+
+    // ========================================
+    // BIGINT CONVENIENCE (ordinary residues in and out)
+    // ========================================
+
+    BigInt mul_mod(const BigInt& a, const BigInt& b) const {
+        detail::Scratch::Frame frame;
+        limb_t* x = load(frame, a);
+        limb_t* y = load(frame, b);
+        to_montgomery(x, x);
+        mul(x, x, y);   // (aR)(b)R^-1 = ab
+        return store(x);
+    }
+
+    BigInt pow_mod(const BigInt& base, const BigInt& exponent) const {
+        detail::Scratch::Frame frame;
+        limb_t* x = load(frame, base);
+        to_montgomery(x, x);
+        pow(x, x, exponent);
+        from_montgomery(x, x);
+        return store(x);
+    }
+
+private:
+    // a mod n into k fresh scratch limbs
+    limb_t* load(detail::Scratch::Frame& frame, const BigInt& a) const {
+        limb_t* x = frame.take(k);
+        std::fill(x, x + k, 0);
+        if (BigInt::compare(a, n) < 0) {
+            std::copy(a.data(), a.data() + a.size(), x);
+        } else {
+            BigInt reduced = a % n;
+            std::copy(reduced.data(), reduced.data() + reduced.size(), x);
+        }
+        return x;
+    }
+
+    BigInt store(const limb_t* x) const { return BigInt::from_limbs(x, k); }
+};
+
+// base^exponent mod m: Montgomery for odd m, square-and-multiply with % otherwise
+inline BigInt pow_mod(const BigInt& base, const BigInt& exponent, const BigInt& m) {
+    if (m.is_zero()) throw std::domain_error("pow_mod: modulus is zero");
+    if (m.is_odd()) return Montgomery(m).pow_mod(base, exponent);
+
+    BigInt result = BigInt(1) % m;
+    BigInt b = base % m;
+    for (size_t i = exponent.bit_length(); i-- > 0;) {
+        result = result * result % m;
+        if (exponent.bit(i)) result = result * b % m;
+    }
+    return result;
+}
+
+} // namespace bigint
@@ -20,176 +20,13 @@ Guaranteed optimal time complexity with GMP integration
 #include <gmpxx.h>
 using BigInt = mpz_class;
 #else
-// Fallback to optimized custom implementation
+// Fallback: the shared big-integer core (Karatsuba/FFT/NTT, Mersenne folding)
 #include <cstdint>
-using namespace std;
-
-class OptimalBigInt {
-private:
-    vector<uint64_t> limbs;
-    static constexpr uint64_t BASE = 1ULL << 32;
-    
-public:
-    OptimalBigInt(uint64_t n = 0) {
-        if (n == 0) limbs = {0};
-        else {
-            while (n > 0) {
-                limbs.push_back(n & 0xFFFFFFFF);
-                n >>= 32;
-            }
-        }
-    }
-    
-    // Optimized squaring (faster than general multiplication)
-    OptimalBigInt square() const {
-        size_t n = limbs.size();
-        vector<uint64_t> result(2 * n, 0);
-        
-        // Diagonal terms
-        for (size_t i = 0; i < n; i++) {
-            __uint128_t prod = (__uint128_t)limbs[i] * limbs[i];
-            result[2*i] += prod & 0xFFFFFFFF;
-            result[2*i + 1] += prod >> 32;
-        }
-        
-        // Off-diagonal terms (doubled)
-        for (size_t i = 0; i < n; i++) {
-            for (size_t j = i + 1; j < n; j++) {
-                __uint128_t prod = (__uint128_t)limbs[i] * limbs[j];
-                uint64_t lo = prod & 0xFFFFFFFF;
-                uint64_t hi = prod >> 32;
-                
-                // Add twice (for symmetry)
-                result[i + j] += 2 * lo;
-                result[i + j + 1] += 2 * hi;
-            }
-        }
-        
-        // Handle carries
-        for (size_t i = 0; i < result.size() - 1; i++) {
-            result[i + 1] += result[i] >> 32;
-            result[i] &= 0xFFFFFFFF;
-        }
-        
-        // Remove leading zeros
-        while (result.size() > 1 && result.back() == 0) {
-            result.pop_back();
-        }
-        
-        OptimalBigInt res;
-        res.limbs = result;
-        return res;
-    }
-    
-    OptimalBigInt operator-(uint64_t n) const {
-        vector<uint64_t> result = limbs;
-        uint64_t borrow = n;
-        
-        for (size_t i = 0; i < result.size() && borrow > 0; i++) {
-            if (result[i] >= borrow) {
-                result[i] -= borrow;
-                borrow = 0;
-            } else {
-                result[i] = result[i] + BASE - borrow;
-                borrow = 1;
-            }
-        }
-        
-        while (result.size() > 1 && result.back() == 0) {
-            result.pop_back();
-        }
-        
-        OptimalBigInt res;
-        res.limbs = result;
-        return res;
-    }
-    
-    // Montgomery reduction for optimal modular arithmetic
-    OptimalBigInt mod_reduce(const OptimalBigInt& mod) const {
-        if (compare(mod) < 0) return *this;
-        
-        // Use binary long division for now (can be optimized with Barrett/Montgomery)
-        OptimalBigInt dividend = *this;
-        while (dividend.compare(mod) >= 0) {
-            dividend = dividend.subtract(mod);
-        }
-        return dividend;
-    }
-    
-    OptimalBigInt subtract(const OptimalBigInt& other) const {
-        vector<uint64_t> result = limbs;
-        uint64_t borrow = 0;
-        
-        for (size_t i = 0; i < max(result.size(), other.limbs.size()); i++) {
-            uint64_t sub = borrow;
-            if (i < other.limbs.size()) sub += other.limbs[i];
-            
-            if (i < result.size() && result[i] >= sub) {
-                result[i] -= sub;
-                borrow = 0;
-            } else {
-                if (i >= result.size()) result.resize(i + 1, 0);
-                result[i] = result[i] + BASE - sub;
-                borrow = 1;
-            }
-        }
-        
-        while (result.size() > 1 && result.back() == 0) {
-            result.pop_back();
-        }
-        
-        OptimalBigInt res;
-        res.limbs = result;
-        return res;
-    }
-    
-    int compare(const OptimalBigInt& other) const {
-        if (limbs.size() != other.limbs.size()) {
-            return limbs.size() < other.limbs.size() ? -1 : 1;
-        }
-        
-        for (int i = limbs.size() - 1; i >= 0; i--) {
-            if (limbs[i] != other.limbs[i]) {
-                return limbs[i] < other.limbs[i] ? -1 : 1;
-            }
-        }
-        return 0;
-    }
-    
-    bool is_zero() const {
-        return limbs.size() == 1 && limbs[0] == 0;
-    }
-    
-    static OptimalBigInt power_of_two_minus_one(int exp) {
-        if (exp <= 32) {
-            return OptimalBigInt((1ULL << exp) - 1);
-        }
-        
-        // Build 2^exp - 1 efficiently
-        int full_limbs = exp / 32;
-        int remaining_bits = exp % 32;
-        
-        vector<uint64_t> result(full_limbs + (remaining_bits > 0 ? 1 : 0));
-        
-        // Set all bits in full limbs
-        for (int i = 0; i < full_limbs; i++) {
-            result[i] = 0xFFFFFFFF;
-        }
-        
-        // Set remaining bits
-        if (remaining_bits > 0) {
-            result[full_limbs] = (1ULL << remaining_bits) - 1;
-        }
-        
-        OptimalBigInt res;
-        res.limbs = result;
-        return res;
-    }
-};
-
-using BigInt = OptimalBigInt;
+#include "big_int.h"
 #endif
 
+using namespace std;
+
 class OptimalLucasLehmer {
 public:
     struct Result {
@@ -246,7 +83,7 @@ public:
             #else
             // Use optimized custom implementation
             BigInt s(4);
-            BigInt M = BigInt::power_of_two_minus_one(p);
+            BigInt M = BigInt::mersenne(p);
             
             for (int i = 0; i < p - 2; i++) {
                 auto now = chrono::high_resolution_clock::now();
@@ -255,10 +92,8 @@ public:
                     return {false, elapsed, i, "Timeout"};
                 }
                 
-                // Optimized: s = (s^2 - 2) mod M
-                s = s.square();
-                s = s - 2;
-                s = s.mod_reduce(M);
+                // Fused: one squaring, subtract and Mersenne fold per iteration
+                s = (s * s - 2) % M;
                 
                 if (i % 10000 == 0 && i > 0) {
                     double progress = (double)i / (p - 2) * 100.0;
@@ -0,0 +1,631 @@
+/*
+💾 OUT-OF-CORE LUCAS-LEHMER / PRP 💾
+For exponents whose residue and FFT scratch do not fit the node's RAM budget.
+
+The residue lives in a scratch file as an R x C matrix of IBDWT-weighted
+balanced digits (one complex<double> per word, row-major by word index).
+Each squaring is a four-step FFT done in three streaming passes:
+  1. column strips - absorb carries, weight, length-R column FFTs, twiddle
+  2. row blocks    - length-C row FFTs, pointwise square, inverse row FFTs
+  3. column strips - inverse twiddle, inverse column FFTs, unweight, carry
+Strip width and row-block height are sized from memory_limit_gb. Blocks move
+through three buffers so the read of the next block and the write-back of the
+previous one overlap the compute on the current one.
+
+MODE_LL:  s = 4, s = s^2 - 2 (p - 2 times), prime iff s == 0 (mod M_p)
+MODE_PRP: base-3 Fermat, x = 3^(2^p), probable prime iff x == 9 (mod M_p)
+
+Scratch files go to MERSENNE_OOC_DIR (default: working directory) and are
+removed when the test finishes.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define MERSENNE_OOC_PREAD 1
+#else
+#define MERSENNE_OOC_PREAD 0
+#endif
+
+#include "fft_plan.h"
+#include "trace_recorder.h"
+
+// ========================================
+// SCRATCH FILE
+// ========================================
+
+// Positional reads and writes, safe to issue from the I/O threads concurrently
+// (disjoint ranges). pread/pwrite where available, else a locked fstream.
+class ScratchFile {
+private:
+    std::string path;
+    std::atomic<uint64_t> read_total{0};
+    std::atomic<uint64_t> write_total{0};
+    #if MERSENNE_OOC_PREAD
+    int fd = -1;
+    #else
+    std::fstream stream;
+    std::mutex stream_mutex;
+    #endif
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string(what) + " " + path + ": " + std::strerror(errno));
+    }
+
+public:
+    ScratchFile(const std::string& file_path, uint64_t bytes) : path(file_path) {
+        #if MERSENNE_OOC_PREAD
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail("cannot create scratch file");
+        if (ftruncate(fd, (off_t)bytes) != 0) fail("cannot size scratch file");  // Sparse: reads as zeros
+        #else
+        { std::ofstream create(path, std::ios::binary | std::ios::trunc); }
+        stream.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!stream.is_open()) fail("cannot create scratch file");
+        stream.seekp((std::streamoff)bytes - 1);
+        stream.put('\0');
+        #endif
+    }
+
+    ~ScratchFile() {
+        #if MERSENNE_OOC_PREAD
+        if (fd >= 0) ::close(fd);
+        #else
+        stream.close();
+        #endif
+        std::remove(path.c_str());
+    }
+
+    ScratchFile(const ScratchFile&) = delete;
+    ScratchFile& operator=(const ScratchFile&) = delete;
+
+    void read_at(void* dst, uint64_t bytes, uint64_t offset) {
+        read_total += bytes;
+        #if MERSENNE_OOC_PREAD
+        char* out = static_cast<char*>(dst);
+        while (bytes > 0) {
+            ssize_t got = ::pread(fd, out, bytes, (off_t)offset);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                fail("read failed on");
+            }
+            if (got == 0) fail("unexpected end of");
+            out += got; bytes -= got; offset += got;
+        }
+        #else
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        stream.seekg((std::streamoff)offset);
+        if (!stream.read(static_cast<char*>(dst), (std::streamsize)bytes)) fail("read failed on");
+        #endif
+    }
+
+    void write_at(const void* src, uint64_t bytes, uint64_t offset) {
+        write_total += bytes;
+        #if MERSENNE_OOC_PREAD
+        const char* in = static_cast<const char*>(src);
+        while (bytes > 0) {
+            ssize_t put = ::pwrite(fd, in, bytes, (off_t)offset);
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                fail("write failed on");
+            }
+            in += put; bytes -= put; offset += put;
+        }
+        #else
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        stream.seekp((std::streamoff)offset);
+        if (!stream.write(static_cast<const char*>(src), (std::streamsize)bytes)) fail("write failed on");
+        #endif
+    }
+
+    uint64_t bytes_read() const { return read_total.load(); }
+    uint64_t bytes_written() const { return write_total.load(); }
+};
+
+// ========================================
+// OUT-OF-CORE ENGINE
+// ========================================
+
+class OutOfCoreLucasLehmer {
+public:
+    enum Mode { MODE_LL, MODE_PRP };
+
+    struct Result {
+        bool is_prime = false;
+        uint64_t res64 = 0;             // Low 64 bits of the final residue
+        size_t fft_length = 0;
+        size_t rows = 0, cols = 0;
+        size_t strip_width = 0;         // Columns per strip (passes 1 and 3)
+        size_t row_block = 0;           // Rows per block (pass 2)
+        double max_roundoff = 0;
+        double computation_time = 0;
+        uint64_t bytes_read = 0;
+        uint64_t bytes_written = 0;
+    };
+
+    // Round-off past this means the FFT length is too short for the exponent
+    struct RoundoffError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    static constexpr double MAX_ROUNDOFF = 0.4;
+    static constexpr size_t MIN_STRIP_WIDTH = 16;   // Carries settle well inside a strip row
+
+private:
+    typedef std::complex<double> cd;
+
+    uint64_t memory_limit;
+    std::string scratch_dir;
+    std::function<void(uint64_t, uint64_t)> progress;
+
+    // Per-run state
+    uint64_t p = 0, base_bits = 0, p_mod_n = 0;
+    size_t n = 0, rows = 0, cols = 0, strip_width = 0, strips = 0, row_block = 0;
+    int split_bits = 0;
+    std::vector<double> weight_lo, weight_hi, inv_weight_lo, inv_weight_hi;
+    std::vector<cd> twiddle_lo, twiddle_hi;
+    std::vector<int64_t> carry_out;                 // [strip * rows + row]: carry leaving that strip row
+    std::vector<std::vector<cd>> buffers;
+    FFTPlan row_plan, column_plan;
+    double max_roundoff = 0;
+
+public:
+    explicit OutOfCoreLucasLehmer(uint64_t memory_limit_bytes, const std::string& directory = "")
+        : memory_limit(memory_limit_bytes), scratch_dir(directory) {
+        if (scratch_dir.empty()) {
+            const char* env = std::getenv("MERSENNE_OOC_DIR");
+            scratch_dir = env ? env : ".";
+        }
+    }
+
+    // "memory_limit_gb" from mersenne_search_config.json (hardware_optimization)
+    static uint64_t load_memory_limit_bytes(const std::string& config_path = "mersenne_search_config.json",
+                                            double default_gb = 8) {
+        double gb = default_gb;
+        std::ifstream file(config_path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+        size_t key = json.find("\"memory_limit_gb\"");
+        if (key != std::string::npos) {
+            size_t colon = json.find(':', key);
+            if (colon != std::string::npos) {
+                double parsed = std::atof(json.c_str() + colon + 1);
+                if (parsed > 0) gb = parsed;
+            }
+        }
+        return (uint64_t)(gb * 1024 * 1024 * 1024);
+    }
+
+    // Shortest power-of-two length whose balanced-digit convolution stays
+    // comfortably inside double precision (~ sqrt(n log n) error growth)
+    static size_t fft_length_for(uint64_t exponent) {
+        for (int log_n = 2; log_n < 48; log_n++) {
+            double max_bits = (53.0 - 0.5 * log_n - std::log2((double)log_n) - 4.0) / 2.0;
+            if ((double)exponent / (double)(1ULL << log_n) <= max_bits) return (size_t)1 << log_n;
+        }
+        return (size_t)1 << 47;
+    }
+
+    static uint64_t residue_bytes(uint64_t exponent) {
+        return (uint64_t)fft_length_for(exponent) * sizeof(cd);
+    }
+
+    // True when the in-memory engines would not fit the configured budget
+    bool needed_for(uint64_t exponent) const {
+        return residue_bytes(exponent) > memory_limit;
+    }
+
+    void set_progress_callback(std::function<void(uint64_t iteration, uint64_t total)> callback) {
+        progress = std::move(callback);
+    }
+
+    // Retries at twice the FFT length if round-off shows the length is too short
+    Result run(uint64_t exponent, Mode mode = MODE_LL, size_t fft_length = 0) {
+        size_t length = fft_length ? fft_length : fft_length_for(exponent);
+        while (true) {
+            try {
+                return run_with_length(exponent, mode, length);
+            } catch (const RoundoffError&) {
+                if (length >= ((size_t)1 << 46)) throw;
+                length *= 2;
+            }
+        }
+    }
+
+private:
+    // ========================================
+    // WORD LAYOUT, WEIGHTS, TWIDDLES
+    // ========================================
+    // Word j holds ceil((j+1)p/n) - ceil(jp/n) bits. Everything per word is a
+    // function of m_j = j*p mod n, which advances by p mod n from word to word.
+
+    uint64_t word_fraction(uint64_t j) const {
+        return (uint64_t)(((unsigned __int128)j * p_mod_n) % n);
+    }
+
+    uint64_t next_fraction(uint64_t m) const {
+        uint64_t next = m + p_mod_n;
+        return next >= n ? next - n : next;
+    }
+
+    int word_bits(uint64_t m) const {
+        uint64_t next = next_fraction(m);
+        return (int)(base_bits + (m + p_mod_n >= n) + (next > 0) - (m > 0));
+    }
+
+    // IBDWT weight 2^(ceil(jp/n) - jp/n) = 2^((n - m)/n), from two sqrt(n)-sized tables
+    double weight(uint64_t m) const {
+        if (m == 0) return 1.0;
+        return 2.0 * weight_hi[m >> split_bits] * weight_lo[m & ((1ULL << split_bits) - 1)];
+    }
+
+    double inverse_weight(uint64_t m) const {
+        if (m == 0) return 1.0;
+        return 0.5 * inv_weight_hi[m >> split_bits] * inv_weight_lo[m & ((1ULL << split_bits) - 1)];
+    }
+
+    // exp(-2*pi*i*e/n) for e < n
+    cd twiddle(uint64_t e) const {
+        return twiddle_hi[e >> split_bits] * twiddle_lo[e & ((1ULL << split_bits) - 1)];
+    }
+
+    static int64_t balanced_digit(int64_t v, int bits, int64_t& carry) {
+        int64_t low = v & ((int64_t(1) << bits) - 1);
+        if (low >= (int64_t(1) << (bits - 1))) low -= int64_t(1) << bits;
+        carry = (v - low) >> bits;
+        return low;
+    }
+
+    void build_tables() {
+        const double PI = 3.14159265358979323846;
+        int log_n = 0;
+        while (((size_t)1 << log_n) < n) log_n++;
+        split_bits = (log_n + 1) / 2;
+        size_t lo_size = (size_t)1 << split_bits, hi_size = (n >> split_bits) + 1;
+
+        weight_lo.resize(lo_size); inv_weight_lo.resize(lo_size); twiddle_lo.resize(lo_size);
+        for (size_t x = 0; x < lo_size; x++) {
+            weight_lo[x] = std::exp2(-(double)x / n);
+            inv_weight_lo[x] = std::exp2((double)x / n);
+            twiddle_lo[x] = std::polar(1.0, -2.0 * PI * (double)x / n);
+        }
+        weight_hi.resize(hi_size); inv_weight_hi.resize(hi_size); twiddle_hi.resize(hi_size);
+        for (size_t y = 0; y < hi_size; y++) {
+            double e = (double)((uint64_t)y << split_bits);
+            weight_hi[y] = std::exp2(-e / n);
+            inv_weight_hi[y] = std::exp2(e / n);
+            twiddle_hi[y] = std::polar(1.0, -2.0 * PI * e / n);
+        }
+    }
+
+    // Strips of full-height columns and blocks of full rows, three of each in flight
+    void plan_layout() {
+        int log_n = 0;
+        while (((size_t)1 << log_n) < n) log_n++;
+        rows = (size_t)1 << (log_n / 2);
+        cols = n / rows;
+
+        uint64_t per_buffer = memory_limit / 3;
+        strip_width = 1;
+        while (strip_width * 2 <= cols && rows * strip_width * 2 * sizeof(cd) <= per_buffer) strip_width *= 2;
+        row_block = 1;
+        while (row_block * 2 <= rows && cols * row_block * 2 * sizeof(cd) <= per_buffer) row_block *= 2;
+
+        size_t min_width = std::min(cols, MIN_STRIP_WIDTH);
+        if (strip_width < min_width || rows * strip_width * sizeof(cd) > per_buffer
+                || cols * row_block * sizeof(cd) > per_buffer) {
+            uint64_t needed = 3 * std::max(rows * min_width, cols) * sizeof(cd);
+            throw std::runtime_error("memory_limit_gb too small for n=" + std::to_string(n) +
+                                     ": need at least " + std::to_string(needed / (1024 * 1024) + 1) + " MB");
+        }
+        strips = cols / strip_width;
+
+        size_t buffer_elems = std::max(rows * strip_width, cols * row_block);
+        buffers.assign(3, std::vector<cd>(buffer_elems));
+        row_plan = FFTPlanner::instance().plan_for(cols);
+        column_plan = FFTPlanner::instance().plan_for(rows);
+    }
+
+    // ========================================
+    // STREAMING
+    // ========================================
+
+    // compute(i) on block i while block i+1 is read and block i-1 written back
+    template <typename Read, typename Compute, typename Write>
+    void stream_blocks(size_t count, Read read, Compute compute, Write write) {
+        std::future<void> reads[3], writes[3];
+        reads[0] = std::async(std::launch::async, [&]() { read(0, buffers[0].data()); });
+        for (size_t i = 0; i < count; i++) {
+            size_t cur = i % 3;
+            if (i + 1 < count) {
+                size_t next = (i + 1) % 3;
+                if (writes[next].valid()) writes[next].get();   // Buffer's previous block is on disk
+                reads[next] = std::async(std::launch::async, [&, i, next]() { read(i + 1, buffers[next].data()); });
+            }
+            reads[cur].get();
+            compute(i, buffers[cur].data());
+            writes[cur] = std::async(std::launch::async, [&, i, cur]() { write(i, buffers[cur].data()); });
+        }
+        for (auto& w : writes) {
+            if (w.valid()) w.get();
+        }
+    }
+
+    void read_strip(ScratchFile& file, size_t s, cd* buffer) {
+        TraceSpan span("ooc_read", "ooc", s);
+        size_t c0 = s * strip_width;
+        if (strip_width == cols) {
+            file.read_at(buffer, (uint64_t)rows * cols * sizeof(cd), 0);
+            return;
+        }
+        for (size_t r = 0; r < rows; r++) {
+            file.read_at(buffer + r * strip_width, strip_width * sizeof(cd), ((uint64_t)r * cols + c0) * sizeof(cd));
+        }
+    }
+
+    void write_strip(ScratchFile& file, size_t s, const cd* buffer) {
+        TraceSpan span("ooc_write", "ooc", s);
+        size_t c0 = s * strip_width;
+        if (strip_width == cols) {
+            file.write_at(buffer, (uint64_t)rows * cols * sizeof(cd), 0);
+            return;
+        }
+        for (size_t r = 0; r < rows; r++) {
+            file.write_at(buffer + r * strip_width, strip_width * sizeof(cd), ((uint64_t)r * cols + c0) * sizeof(cd));
+        }
+    }
+
+    void read_rows(ScratchFile& file, size_t b, cd* buffer) {
+        TraceSpan span("ooc_read", "ooc", b);
+        file.read_at(buffer, (uint64_t)row_block * cols * sizeof(cd), (uint64_t)b * row_block * cols * sizeof(cd));
+    }
+
+    void write_rows(ScratchFile& file, size_t b, const cd* buffer) {
+        TraceSpan span("ooc_write", "ooc", b);
+        file.write_at(buffer, (uint64_t)row_block * cols * sizeof(cd), (uint64_t)b * row_block * cols * sizeof(cd));
+    }
+
+    // Slot holding the carry that enters strip s of row r
+    size_t incoming_carry_slot(size_t s, size_t r) const {
+        if (s > 0) return (s - 1) * rows + r;
+        return (strips - 1) * rows + (r == 0 ? rows - 1 : r - 1);   // Top word wraps to word 0
+    }
+
+    // ========================================
+    // THE THREE PASSES
+    // ========================================
+
+    void forward_columns(ScratchFile& file) {
+        TraceSpan span("ooc_forward_columns", "ooc", n);
+        std::vector<cd> column(rows);
+        stream_blocks(strips,
+            [&](size_t s, cd* buf) { read_strip(file, s, buf); },
+            [&](size_t s, cd* buf) {
+                size_t c0 = s * strip_width;
+                for (size_t r = 0; r < rows; r++) {
+                    cd* row = buf + r * strip_width;
+                    uint64_t j0 = (uint64_t)r * cols + c0;
+
+                    // Absorb the carry left by the previous strip (or row)
+                    size_t slot = incoming_carry_slot(s, r);
+                    int64_t carry = carry_out[slot];
+                    carry_out[slot] = 0;
+                    uint64_t m = word_fraction(j0);
+                    for (size_t w = 0; w < strip_width && carry != 0; w++) {
+                        int64_t v = (int64_t)row[w].real() + carry;
+                        row[w] = cd((double)balanced_digit(v, word_bits(m), carry), 0);
+                        m = next_fraction(m);
+                    }
+                    if (carry != 0) {
+                        if (s + 1 == strips) throw std::runtime_error("carry crossed a row boundary");
+                        carry_out[s * rows + r] += carry;
+                    }
+
+                    m = word_fraction(j0);
+                    for (size_t w = 0; w < strip_width; w++) {
+                        row[w] *= weight(m);
+                        m = next_fraction(m);
+                    }
+                }
+
+                for (size_t w = 0; w < strip_width; w++) {
+                    uint64_t c = c0 + w;
+                    for (size_t k = 0; k < rows; k++) column[k] = buf[k * strip_width + w];
+                    FFTPlanner::instance().execute(column_plan, column, false);
+                    for (size_t k = 0; k < rows; k++) buf[k * strip_width + w] = column[k] * twiddle(c * k);
+                }
+            },
+            [&](size_t s, const cd* buf) { write_strip(file, s, buf); });
+    }
+
+    void square_rows(ScratchFile& file) {
+        TraceSpan span("ooc_square_rows", "ooc", n);
+        stream_blocks(rows / row_block,
+            [&](size_t b, cd* buf) { read_rows(file, b, buf); },
+            [&](size_t, cd* buf) {
+                for (size_t i = 0; i < row_block; i++) {
+                    cd* row = buf + i * cols;
+                    FFTPlanner::instance().execute(row_plan, row, cols, false);
+                    for (size_t c = 0; c < cols; c++) row[c] *= row[c];
+                    FFTPlanner::instance().execute(row_plan, row, cols, true);
+                }
+            },
+            [&](size_t b, const cd* buf) { write_rows(file, b, buf); });
+    }
+
+    void inverse_columns(ScratchFile& file, int64_t subtract) {
+        TraceSpan span("ooc_inverse_columns", "ooc", n);
+        std::vector<cd> column(rows);
+        stream_blocks(strips,
+            [&](size_t s, cd* buf) { read_strip(file, s, buf); },
+            [&](size_t s, cd* buf) {
+                size_t c0 = s * strip_width;
+                for (size_t w = 0; w < strip_width; w++) {
+                    uint64_t c = c0 + w;
+                    for (size_t k = 0; k < rows; k++) column[k] = buf[k * strip_width + w] * std::conj(twiddle(c * k));
+                    FFTPlanner::instance().execute(column_plan, column, true);
+                    for (size_t k = 0; k < rows; k++) buf[k * strip_width + w] = column[k];
+                }
+
+                // Row-then-column inverses scaled by 1/cols * 1/rows = 1/n
+                for (size_t r = 0; r < rows; r++) {
+                    cd* row = buf + r * strip_width;
+                    uint64_t j0 = (uint64_t)r * cols + c0;
+                    uint64_t m = word_fraction(j0);
+                    int64_t carry = 0;
+                    for (size_t w = 0; w < strip_width; w++) {
+                        double x = row[w].real() * inverse_weight(m);
+                        double rounded = std::nearbyint(x);
+                        max_roundoff = std::max(max_roundoff, std::fabs(x - rounded));
+                        int64_t v = (int64_t)rounded + carry;
+                        if (j0 + w == 0) v -= subtract;
+                        row[w] = cd((double)balanced_digit(v, word_bits(m), carry), 0);
+                        m = next_fraction(m);
+                    }
+                    carry_out[s * rows + r] = carry;
+                }
+            },
+            [&](size_t s, const cd* buf) { write_strip(file, s, buf); });
+
+        if (max_roundoff > MAX_ROUNDOFF) {
+            throw RoundoffError("round-off " + std::to_string(max_roundoff) + " at n=" + std::to_string(n));
+        }
+    }
+
+    // ========================================
+    // RESULT
+    // ========================================
+
+    struct Summary {
+        bool all_zero = true;
+        bool all_max = true;
+        bool zero_above_64 = true;
+        uint64_t res64 = 0;
+    };
+
+    // Fold pending carries in and rewrite as non-negative digits, repeating
+    // while a carry wraps from the top word back to word 0
+    Summary normalize(ScratchFile& file) {
+        Summary summary;
+        int64_t wrap = carry_out[(strips - 1) * rows + rows - 1];
+        carry_out[(strips - 1) * rows + rows - 1] = 0;
+
+        for (int sweep = 0; sweep < 8; sweep++) {
+            summary = Summary();
+            int64_t carry = wrap;
+            uint64_t bit_position = 0;
+            stream_blocks(rows / row_block,
+                [&](size_t b, cd* buf) { read_rows(file, b, buf); },
+                [&](size_t b, cd* buf) {
+                    for (size_t i = 0; i < row_block; i++) {
+                        size_t r = b * row_block + i;
+                        uint64_t m = word_fraction((uint64_t)r * cols);
+                        for (size_t c = 0; c < cols; c++) {
+                            if (c % strip_width == 0 && !(r == 0 && c == 0)) {
+                                size_t slot = incoming_carry_slot(c / strip_width, r);
+                                carry += carry_out[slot];
+                                carry_out[slot] = 0;
+                            }
+                            int bits = word_bits(m);
+                            int64_t v = (int64_t)buf[i * cols + c].real() + carry;
+                            int64_t digit = v & ((int64_t(1) << bits) - 1);
+                            carry = (v - digit) >> bits;
+                            buf[i * cols + c] = cd((double)digit, 0);
+
+                            if (digit != 0) summary.all_zero = false;
+                            if (digit != (int64_t(1) << bits) - 1) summary.all_max = false;
+                            if (bit_position < 64) {
+                                summary.res64 |= (uint64_t)digit << bit_position;
+                                if (bit_position + bits > 64 && ((uint64_t)digit >> (64 - bit_position)) != 0) {
+                                    summary.zero_above_64 = false;
+                                }
+                            } else if (digit != 0) {
+                                summary.zero_above_64 = false;
+                            }
+                            bit_position += bits;
+                            m = next_fraction(m);
+                        }
+                    }
+                },
+                [&](size_t b, const cd* buf) { write_rows(file, b, buf); });
+
+            wrap = carry;
+            if (wrap == 0) break;
+        }
+        if (wrap != 0) throw std::runtime_error("residue normalization did not converge");
+        return summary;
+    }
+
+    Result run_with_length(uint64_t exponent, Mode mode, size_t length) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        TraceSpan span("ooc_test", "ooc", exponent);
+
+        p = exponent;
+        n = length;
+        base_bits = p / n;
+        p_mod_n = p % n;
+        max_roundoff = 0;
+        if (base_bits < 2 || base_bits > 30) {
+            throw std::runtime_error("FFT length " + std::to_string(n) + " does not suit p=" + std::to_string(p));
+        }
+        plan_layout();
+        build_tables();
+        carry_out.assign(strips * rows, 0);
+
+        std::string path = scratch_dir + "/mersenne_ooc_" + std::to_string(p) + ".residue";
+        ScratchFile file(path, (uint64_t)n * sizeof(cd));
+        cd seed(mode == MODE_LL ? 4.0 : 3.0, 0);
+        file.write_at(&seed, sizeof(cd), 0);
+
+        uint64_t iterations = mode == MODE_LL ? p - 2 : p;
+        int64_t subtract = mode == MODE_LL ? 2 : 0;
+        for (uint64_t it = 0; it < iterations; it++) {
+            forward_columns(file);
+            square_rows(file);
+            inverse_columns(file, subtract);
+            if (progress) progress(it + 1, iterations);
+        }
+
+        Summary summary = normalize(file);
+        bool is_zero = summary.all_zero || summary.all_max;   // 0 and M_p both represent zero
+
+        Result result;
+        result.res64 = is_zero ? 0 : summary.res64;
+        result.is_prime = mode == MODE_LL ? is_zero
+                                          : (!is_zero && summary.res64 == 9 && summary.zero_above_64);
+        result.fft_length = n;
+        result.rows = rows;
+        result.cols = cols;
+        result.strip_width = strip_width;
+        result.row_block = row_block;
+        result.max_roundoff = max_roundoff;
+        result.bytes_read = file.bytes_read();
+        result.bytes_written = file.bytes_written();
+        result.computation_time = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - start_time).count();
+        buffers.clear();
+        return result;
+    }
+};
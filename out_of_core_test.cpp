@@ -0,0 +1,73 @@
+/*
+💾 OUT-OF-CORE MERSENNE TEST 💾
+Runs a Lucas-Lehmer or base-3 PRP test with the residue streamed from disk,
+bounded by memory_limit_gb from mersenne_search_config.json.
+
+Usage: out_of_core_test <exponent> [ll|prp] [memory_limit_gb]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+
+#include "out_of_core_ll.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    ios::sync_with_stdio(false);
+
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <exponent> [ll|prp] [memory_limit_gb]\n";
+        return 1;
+    }
+
+    uint64_t p = strtoull(argv[1], nullptr, 10);
+    OutOfCoreLucasLehmer::Mode mode = OutOfCoreLucasLehmer::MODE_LL;
+    if (argc >= 3 && string(argv[2]) == "prp") mode = OutOfCoreLucasLehmer::MODE_PRP;
+
+    uint64_t memory_limit = OutOfCoreLucasLehmer::load_memory_limit_bytes();
+    if (argc >= 4) memory_limit = (uint64_t)(atof(argv[3]) * 1024 * 1024 * 1024);
+
+    if (p < 3) {
+        cerr << "Exponent must be at least 3\n";
+        return 1;
+    }
+
+    cout << "💾 Out-of-core " << (mode == OutOfCoreLucasLehmer::MODE_LL ? "Lucas-Lehmer" : "PRP-3")
+         << " test of 2^" << p << " - 1" << endl;
+    cout << "📦 Memory limit: " << fixed << setprecision(3) << memory_limit / (1024.0 * 1024 * 1024) << " GB" << endl;
+    cout << "📐 Residue: " << OutOfCoreLucasLehmer::residue_bytes(p) / (1024.0 * 1024) << " MB at n="
+         << OutOfCoreLucasLehmer::fft_length_for(p) << endl;
+    cout << "========================================" << endl;
+
+    OutOfCoreLucasLehmer engine(memory_limit);
+    auto last_report = chrono::steady_clock::now();
+    engine.set_progress_callback([&](uint64_t iteration, uint64_t total) {
+        auto now = chrono::steady_clock::now();
+        if (now - last_report < chrono::seconds(2) && iteration != total) return;
+        last_report = now;
+        cout << "\r   Iteration " << iteration << "/" << total << " ("
+             << setprecision(1) << 100.0 * iteration / total << "%)" << flush;
+    });
+
+    try {
+        OutOfCoreLucasLehmer::Result result = engine.run(p, mode);
+        cout << "\n========================================" << endl;
+        cout << (result.is_prime ? "🎉 2^" + to_string(p) + " - 1 is " + (mode == OutOfCoreLucasLehmer::MODE_LL ? "PRIME" : "a probable prime")
+                                 : "❌ 2^" + to_string(p) + " - 1 is composite") << endl;
+        cout << "Res64: " << hex << setw(16) << setfill('0') << result.res64 << dec << setfill(' ') << endl;
+        cout << "FFT: n=" << result.fft_length << " (" << result.rows << " x " << result.cols << "), strip "
+             << result.strip_width << " cols, row block " << result.row_block << " rows" << endl;
+        cout << "Max round-off: " << setprecision(4) << result.max_roundoff << endl;
+        cout << "I/O: " << setprecision(1) << result.bytes_read / (1024.0 * 1024) << " MB read, "
+             << result.bytes_written / (1024.0 * 1024) << " MB written" << endl;
+        cout << "Time: " << setprecision(2) << result.computation_time << " s" << endl;
+    } catch (const exception& e) {
+        cerr << "\n❌ " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,304 @@
+/*
+📊 INCREMENTAL RESULT STATISTICS 📊
+Dashboard aggregates maintained as each result is appended, so a query costs
+the same after ten results or ten million - nothing ever rescans the results.
+
+- Counts by status and by exponent range (fixed-width buckets)
+- Throughput time series (tests, iterations, GHz-days) in ring buffers at
+  1 s, 1 min and 1 h resolution; a slot is recycled when its period comes round
+- GHz-days per host: CPU-seconds x host clock / 86400, the same credit unit
+  PrimeNet reports
+- Trial-factoring depth distribution (one bucket per bit level, 0 = none);
+  results from engines that don't report a depth are left out of it
+- Discovery list, in the order found
+
+Every update is O(1) (O(log k) for the k status / range / host keys); a
+snapshot walks only the fixed-size rings and those keys.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "json_string.h"
+
+struct ResultRecord {
+    uint64_t exponent = 0;
+    std::string status;           // "Completed", "Timeout", ...
+    bool is_prime = false;
+    double seconds = 0;           // CPU-seconds spent on the test
+    uint64_t iterations = 0;
+    std::string host;             // Empty = this host
+    double ghz = 0;               // Host clock; 0 = this host's
+    double tf_bits = -1;          // Trial factored to 2^tf_bits (0 = not at all, < 0 = not reported)
+};
+
+class ResultStatistics {
+public:
+    struct Discovery {
+        uint64_t exponent;
+        double seconds;
+        std::string host;
+        int64_t unix_time;
+    };
+
+private:
+    // One ring of fixed-length periods; slot i holds period e when e % size == i
+    class ThroughputRing {
+    private:
+        struct Slot {
+            int64_t period = -1;
+            uint64_t tests = 0;
+            uint64_t iterations = 0;
+            double ghz_days = 0;
+        };
+        int64_t resolution;
+        std::vector<Slot> slots;
+
+    public:
+        ThroughputRing(int64_t resolution_seconds, size_t size)
+            : resolution(resolution_seconds), slots(size) {}
+
+        void add(int64_t unix_time, uint64_t iterations, double ghz_days) {
+            int64_t period = unix_time / resolution;
+            Slot& s = slots[(size_t)(period % (int64_t)slots.size())];
+            if (s.period != period) s = Slot{period};
+            s.tests++;
+            s.iterations += iterations;
+            s.ghz_days += ghz_days;
+        }
+
+        // Oldest to newest, ending at the period containing `now`; periods
+        // with no results (or already overwritten) read as zero
+        template <typename Out>
+        void write_json(Out& json, int64_t now) const {
+            int64_t last = now / resolution;
+            int64_t first = last - (int64_t)slots.size() + 1;
+            json << "{\"resolution_seconds\":" << resolution << ",\"start\":" << first * resolution
+                 << ",\"tests\":[";
+            for (int64_t p = first; p <= last; p++) {
+                const Slot* s = slot_for(p);
+                json << (p > first ? "," : "") << (s ? s->tests : 0);
+            }
+            json << "],\"iterations\":[";
+            for (int64_t p = first; p <= last; p++) {
+                const Slot* s = slot_for(p);
+                json << (p > first ? "," : "") << (s ? s->iterations : 0);
+            }
+            json << "],\"ghz_days\":[";
+            for (int64_t p = first; p <= last; p++) {
+                const Slot* s = slot_for(p);
+                json << (p > first ? "," : "") << (s ? s->ghz_days : 0.0);
+            }
+            json << "]}";
+        }
+
+    private:
+        const Slot* slot_for(int64_t period) const {
+            if (period < 0) return nullptr;
+            const Slot& s = slots[(size_t)(period % (int64_t)slots.size())];
+            return s.period == period ? &s : nullptr;
+        }
+    };
+
+    struct RangeCounts {
+        uint64_t tested = 0, primes = 0, composite = 0, unfinished = 0;
+    };
+
+    struct HostTotals {
+        uint64_t tests = 0;
+        double seconds = 0;
+        double ghz_days = 0;
+    };
+
+    static constexpr size_t MAX_TF_BITS = 96;
+
+    const uint64_t range_width;
+    mutable std::mutex mutex;
+
+    uint64_t total_tests = 0;
+    uint64_t total_iterations = 0;
+    double total_seconds = 0;
+    double total_ghz_days = 0;
+    int64_t first_result = 0, last_result = 0;
+
+    std::map<std::string, uint64_t> by_status;
+    std::map<uint64_t, RangeCounts> by_range;        // Keyed by exponent / range_width
+    std::map<std::string, HostTotals> by_host;
+    std::array<uint64_t, MAX_TF_BITS + 1> tf_depth{};
+    std::vector<Discovery> discoveries;
+
+    ThroughputRing per_second{1, 120};
+    ThroughputRing per_minute{60, 120};
+    ThroughputRing per_hour{3600, 168};
+
+    static int64_t unix_now() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+public:
+    explicit ResultStatistics(uint64_t exponent_range_width = 1000000)
+        : range_width(std::max<uint64_t>(1, exponent_range_width)) {}
+
+    // This host's name and nominal clock, read once
+    static const std::string& local_host() {
+        static const std::string* name = [] {
+            char buffer[256] = "localhost";
+            #ifndef _WIN32
+            if (gethostname(buffer, sizeof(buffer)) != 0) std::snprintf(buffer, sizeof(buffer), "localhost");
+            buffer[sizeof(buffer) - 1] = 0;
+            #endif
+            return new std::string(buffer);
+        }();
+        return *name;
+    }
+
+    static double local_ghz() {
+        static const double ghz = [] {
+            // Linux reports the current clock per core; the first is close enough
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line)) {
+                if (line.compare(0, 7, "cpu MHz") != 0) continue;
+                size_t colon = line.find(':');
+                if (colon == std::string::npos) break;
+                double mhz = std::atof(line.c_str() + colon + 1);
+                if (mhz > 0) return mhz / 1000.0;
+            }
+            return 1.0;   // Unknown: credit CPU-days
+        }();
+        return ghz;
+    }
+
+    void record(const ResultRecord& r) {
+        int64_t now = unix_now();
+        const std::string& host = r.host.empty() ? local_host() : r.host;
+        double ghz_days = r.seconds * (r.ghz > 0 ? r.ghz : local_ghz()) / 86400.0;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (total_tests == 0) first_result = now;
+        last_result = now;
+        total_tests++;
+        total_iterations += r.iterations;
+        total_seconds += r.seconds;
+        total_ghz_days += ghz_days;
+
+        by_status[r.status]++;
+
+        RangeCounts& range = by_range[r.exponent / range_width];
+        range.tested++;
+        if (r.status != "Completed" && !r.is_prime) range.unfinished++;
+        else if (r.is_prime) range.primes++;
+        else range.composite++;
+
+        HostTotals& h = by_host[host];
+        h.tests++;
+        h.seconds += r.seconds;
+        h.ghz_days += ghz_days;
+
+        if (r.tf_bits >= 0) tf_depth[(size_t)std::min<double>(r.tf_bits, (double)MAX_TF_BITS)]++;
+
+        if (r.is_prime) discoveries.push_back({r.exponent, r.seconds, host, now});
+
+        per_second.add(now, r.iterations, ghz_days);
+        per_minute.add(now, r.iterations, ghz_days);
+        per_hour.add(now, r.iterations, ghz_days);
+    }
+
+    uint64_t tests() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return total_tests;
+    }
+
+    std::vector<Discovery> discovery_list() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return discoveries;
+    }
+
+    std::string to_json() const {
+        std::ostringstream json;
+        write_json(json);
+        return json.str();
+    }
+
+    // Any sink with stream-style << (std::ostream, ArenaBuffer)
+    template <typename Out>
+    void write_json(Out& json) const {
+        int64_t now = unix_now();
+        std::lock_guard<std::mutex> lock(mutex);
+
+        double span = (double)std::max<int64_t>(1, last_result - first_result);
+        json << "{\"totals\":{\"tests\":" << total_tests << ",\"iterations\":" << total_iterations
+             << ",\"cpu_seconds\":" << total_seconds << ",\"ghz_days\":" << total_ghz_days
+             << ",\"first_result\":" << first_result << ",\"last_result\":" << last_result
+             << ",\"tests_per_hour\":" << (total_tests > 1 ? 3600.0 * (total_tests - 1) / span : 0.0) << "},";
+
+        json << "\"by_status\":{";
+        bool first = true;
+        for (const auto& [status, count] : by_status) {
+            json << (first ? "" : ",");
+            write_json_string(json, status);
+            json << ":" << count;
+            first = false;
+        }
+
+        json << "},\"by_range\":[";
+        first = true;
+        for (const auto& [bucket, c] : by_range) {
+            json << (first ? "" : ",") << "{\"from\":" << bucket * range_width << ",\"to\":" << (bucket + 1) * range_width - 1
+                 << ",\"tested\":" << c.tested << ",\"primes\":" << c.primes << ",\"composite\":" << c.composite
+                 << ",\"unfinished\":" << c.unfinished << "}";
+            first = false;
+        }
+
+        json << "],\"hosts\":[";
+        first = true;
+        for (const auto& [host, h] : by_host) {
+            json << (first ? "" : ",") << "{\"host\":";
+            write_json_string(json, host);
+            json << ",\"tests\":" << h.tests << ",\"cpu_seconds\":" << h.seconds << ",\"ghz_days\":" << h.ghz_days << "}";
+            first = false;
+        }
+
+        json << "],\"factor_depth\":{";
+        first = true;
+        for (size_t bits = 0; bits <= MAX_TF_BITS; bits++) {
+            if (!tf_depth[bits]) continue;
+            json << (first ? "" : ",") << "\"" << bits << "\":" << tf_depth[bits];
+            first = false;
+        }
+
+        json << "},\"discoveries\":[";
+        for (size_t i = 0; i < discoveries.size(); i++) {
+            const Discovery& d = discoveries[i];
+            json << (i ? "," : "") << "{\"exponent\":" << d.exponent << ",\"seconds\":" << d.seconds << ",\"host\":";
+            write_json_string(json, d.host);
+            json << ",\"time\":" << d.unix_time << "}";
+        }
+
+        json << "],\"throughput\":{\"second\":";
+        per_second.write_json(json, now);
+        json << ",\"minute\":";
+        per_minute.write_json(json, now);
+        json << ",\"hour\":";
+        per_hour.write_json(json, now);
+        json << "}}";
+    }
+};
@@ -0,0 +1,281 @@
+/*
+🔥 BUILT-IN SAMPLING PROFILER 🔥
+Opt-in SIGPROF sampler driven by per-thread CPU-time timers (timer_create).
+Stacks are walked through frame pointers inside the signal handler, pushed into a
+lock-free sample buffer, and aggregated into folded-stack text for flame graphs
+(flamegraph.pl / speedscope / inferno).
+
+Enable with MERSENNE_PROFILE=1 (MERSENNE_PROFILE_HZ sets the rate, default 99).
+Build with -fno-omit-frame-pointer -rdynamic for complete, symbolized stacks.
+Linux only - elsewhere every call is a no-op.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <csignal>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+class SamplingProfiler {
+public:
+    static constexpr int MAX_DEPTH = 48;
+    static constexpr size_t BUFFER_SLOTS = 4096;
+
+private:
+    enum SlotState : uint32_t { SLOT_EMPTY = 0, SLOT_WRITING = 1, SLOT_READY = 2 };
+
+    struct Sample {
+        std::atomic<uint32_t> state{SLOT_EMPTY};
+        uint32_t depth = 0;
+        uintptr_t frames[MAX_DEPTH];
+    };
+
+    // Written from signal handlers: fixed storage, claimed with CAS, never allocates
+    Sample samples[BUFFER_SLOTS];
+    std::atomic<uint64_t> write_cursor{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex aggregate_mutex;
+    std::map<std::vector<uintptr_t>, uint64_t> folded;
+    uint64_t total_samples = 0;
+
+    bool enabled = false;
+    int sample_hz = 99;
+
+    SamplingProfiler() {
+        const char* env = std::getenv("MERSENNE_PROFILE");
+        enabled = env && std::string(env) == "1";
+        if (const char* hz = std::getenv("MERSENNE_PROFILE_HZ")) {
+            sample_hz = std::max(1, std::atoi(hz));
+        }
+        #ifdef __linux__
+        if (enabled) install();
+        #else
+        enabled = false;
+        #endif
+    }
+
+    #ifdef __linux__
+    // Bounds of the current thread's stack, used to validate frame pointers
+    static uintptr_t& stack_low() { static thread_local uintptr_t v = 0; return v; }
+    static uintptr_t& stack_high() { static thread_local uintptr_t v = 0; return v; }
+
+    static void on_sigprof(int, siginfo_t*, void* context) {
+        SamplingProfiler& self = instance();
+        ucontext_t* uc = static_cast<ucontext_t*>(context);
+
+        uintptr_t pc, fp, sp;
+        #if defined(__x86_64__)
+        pc = uc->uc_mcontext.gregs[REG_RIP];
+        fp = uc->uc_mcontext.gregs[REG_RBP];
+        sp = uc->uc_mcontext.gregs[REG_RSP];
+        #elif defined(__aarch64__)
+        pc = uc->uc_mcontext.pc;
+        fp = uc->uc_mcontext.regs[29];
+        sp = uc->uc_mcontext.sp;
+        #else
+        return;
+        #endif
+
+        uint64_t ticket = self.write_cursor.fetch_add(1, std::memory_order_relaxed);
+        Sample& slot = self.samples[ticket % BUFFER_SLOTS];
+        uint32_t expected = SLOT_EMPTY;
+        if (!slot.state.compare_exchange_strong(expected, SLOT_WRITING, std::memory_order_acquire)) {
+            self.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        uint32_t depth = 0;
+        slot.frames[depth++] = pc;
+
+        // Live frames sit between the interrupted sp and the stack top; anything
+        // else is a clobbered frame pointer (possibly pointing at unmapped stack)
+        uintptr_t lo = std::max(stack_low(), sp), hi = stack_high();
+        while (depth < MAX_DEPTH && fp >= lo && fp + 2 * sizeof(uintptr_t) <= hi && (fp & (sizeof(uintptr_t) - 1)) == 0) {
+            uintptr_t* frame = reinterpret_cast<uintptr_t*>(fp);
+            uintptr_t next_fp = frame[0];
+            uintptr_t ret = frame[1];
+            if (ret == 0) break;
+            slot.frames[depth++] = ret - 1;  // Point inside the call instruction
+            if (next_fp <= fp) break;        // Stack grows down; frames must move up
+            fp = next_fp;
+        }
+
+        slot.depth = depth;
+        slot.state.store(SLOT_READY, std::memory_order_release);
+    }
+
+    void install() {
+        struct sigaction action = {};
+        action.sa_sigaction = &SamplingProfiler::on_sigprof;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, nullptr);
+
+        // Drain the sample buffer off the signal path
+        std::thread([this]() {
+            while (true) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                drain();
+            }
+        }).detach();
+
+        std::atexit([]() { instance().dump_to_file("mersenne_profile.folded"); });
+    }
+    #endif
+
+    void drain() {
+        std::lock_guard<std::mutex> lock(aggregate_mutex);
+        for (Sample& slot : samples) {
+            if (slot.state.load(std::memory_order_acquire) != SLOT_READY) continue;
+            // Stored leaf-first; folded format wants root-first
+            std::vector<uintptr_t> stack(slot.frames, slot.frames + slot.depth);
+            slot.state.store(SLOT_EMPTY, std::memory_order_release);
+            folded[std::vector<uintptr_t>(stack.rbegin(), stack.rend())]++;
+            total_samples++;
+        }
+    }
+
+    static std::string symbolize(uintptr_t address) {
+        #ifdef __linux__
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+            std::free(demangled);
+            // ';' separates frames in folded output
+            for (char& c : name) if (c == ';') c = ':';
+            return name;
+        }
+        #endif
+        std::stringstream hex;
+        hex << "0x" << std::hex << address;
+        return hex.str();
+    }
+
+public:
+    // Intentionally leaked: signal handlers, the drain thread and the atexit
+    // dump may all run after static destructors have started
+    static SamplingProfiler& instance() {
+        static SamplingProfiler* profiler = new SamplingProfiler();
+        return *profiler;
+    }
+
+    bool is_enabled() const { return enabled; }
+    uint64_t dropped_samples() const { return dropped.load(); }
+
+    // Per-thread CPU-time timer delivering SIGPROF to this thread only.
+    // Call from each thread that should be sampled; the guard below does it via RAII.
+    void* register_thread() {
+        #ifdef __linux__
+        if (!enabled) return nullptr;
+
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+            void* base;
+            size_t size;
+            pthread_attr_getstack(&attr, &base, &size);
+            stack_low() = reinterpret_cast<uintptr_t>(base);
+            stack_high() = stack_low() + size;
+            pthread_attr_destroy(&attr);
+        }
+
+        struct sigevent event = {};
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = SIGPROF;
+        event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+
+        timer_t timer;
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) return nullptr;
+
+        long interval_ns = 1000000000L / sample_hz;
+        struct itimerspec spec = {};
+        spec.it_interval.tv_sec = interval_ns / 1000000000L;
+        spec.it_interval.tv_nsec = interval_ns % 1000000000L;
+        spec.it_value = spec.it_interval;
+        timer_settime(timer, 0, &spec, nullptr);
+        return reinterpret_cast<void*>(timer);
+        #else
+        return nullptr;
+        #endif
+    }
+
+    void unregister_thread(void* handle) {
+        #ifdef __linux__
+        if (handle) timer_delete(reinterpret_cast<timer_t>(handle));
+        #else
+        (void)handle;
+        #endif
+    }
+
+    // Folded stacks: "root;caller;leaf count" per line
+    std::string export_folded() {
+        drain();
+        std::lock_guard<std::mutex> lock(aggregate_mutex);
+
+        std::map<uintptr_t, std::string> symbol_cache;
+        std::map<std::string, uint64_t> lines;
+        for (const auto& [stack, count] : folded) {
+            std::string line;
+            for (uintptr_t address : stack) {
+                auto it = symbol_cache.find(address);
+                if (it == symbol_cache.end()) it = symbol_cache.emplace(address, symbolize(address)).first;
+                if (!line.empty()) line += ';';
+                line += it->second;
+            }
+            lines[line] += count;
+        }
+
+        std::stringstream out;
+        for (const auto& [line, count] : lines) {
+            out << line << " " << count << "\n";
+        }
+        return out.str();
+    }
+
+    bool dump_to_file(const std::string& path) {
+        if (!enabled) return false;
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+        file << export_folded();
+        return true;
+    }
+};
+
+// RAII registration for worker threads
+class ProfiledThread {
+private:
+    void* handle;
+
+public:
+    ProfiledThread() : handle(SamplingProfiler::instance().register_thread()) {}
+    ~ProfiledThread() { SamplingProfiler::instance().unregister_thread(handle); }
+
+    ProfiledThread(const ProfiledThread&) = delete;
+    ProfiledThread& operator=(const ProfiledThread&) = delete;
+};
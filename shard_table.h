@@ -0,0 +1,265 @@
+/*
+🧩 SINGLE-NODE SHARDING TABLE 🧩
+Lets several engine processes on one host split an exponent range without a
+coordinator: they attach to one shared-memory segment holding a chunk-claim
+table and a heartbeat per process.
+
+- Chunks go free -> claimed (by a process slot + generation) -> done, every
+  transition a compare-and-swap, so a chunk is never handed out twice
+- Each process beats its slot's heartbeat from a background thread; a claim
+  whose owner is silent for longer than the stale timeout is reclaimed by the
+  next process that looks for work
+- complete() only succeeds for the current owner, so a stalled process that
+  wakes up after its chunk was reclaimed cannot report it twice
+
+Segments live in /dev/shm as mersenne-shard-<lo>-<hi>-<chunk>-v1 until
+reboot (or rm); every process sharding the same range attaches to the same one.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "shared_tables.h"
+
+class ShardTable {
+public:
+    static constexpr size_t MAX_PROCESSES = 64;
+    static constexpr uint64_t FREE = 0;
+    static constexpr uint64_t DONE = ~0ULL;
+
+    struct Summary {
+        uint64_t chunks = 0, done = 0, claimed = 0, free = 0;
+        size_t live_processes = 0;
+    };
+
+private:
+    static constexpr uint64_t SEGMENT_MAGIC = 0x4d45525353484431ULL;  // "MERSSHD1"
+
+    struct ProcessSlot {
+        std::atomic<uint64_t> generation;    // Odd while held by a live process
+        std::atomic<int64_t> heartbeat_ms;   // steady_clock, node-wide on Linux
+        std::atomic<uint64_t> chunks_done;
+    };
+
+    struct Header {
+        uint64_t magic;
+        uint64_t range_lo, range_hi, chunk_size, chunk_count;
+        std::atomic<uint32_t> ready;
+        ProcessSlot slots[MAX_PROCESSES];
+    };
+
+    Header* header = nullptr;
+    std::atomic<uint64_t>* chunks = nullptr;   // Claim word per chunk
+    size_t mapped_bytes = 0;
+    size_t slot = 0;
+    uint64_t claim_word = 0;                   // (generation << 8) | (slot + 1)
+    int64_t stale_ms;
+
+    std::atomic<bool> running{true};
+    std::thread heartbeat_thread;
+
+    static int64_t now_ms() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // A claim is orphaned when its slot was re-taken or has stopped beating
+    bool orphaned(uint64_t word, int64_t now) const {
+        size_t owner = (size_t)(word & 0xff) - 1;
+        if (owner >= MAX_PROCESSES) return true;
+        const ProcessSlot& s = header->slots[owner];
+        if (s.generation.load(std::memory_order_acquire) != (word >> 8)) return true;
+        return now - s.heartbeat_ms.load(std::memory_order_acquire) > stale_ms;
+    }
+
+    void attach(const std::string& name, uint64_t lo, uint64_t hi, uint64_t chunk_size) {
+        #if MERSENNE_SHARED_SEGMENTS
+        uint64_t count = (hi - lo) / chunk_size + 1;
+        mapped_bytes = sizeof(Header) + count * sizeof(std::atomic<uint64_t>);
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        bool creator = fd >= 0;
+        if (!creator) fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) throw std::runtime_error("ShardTable: cannot open " + name);
+
+        if (creator && ftruncate(fd, (off_t)mapped_bytes) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ShardTable: cannot size " + name);
+        }
+
+        // Joiners wait for the creator to size and publish the table
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        struct stat st;
+        while (fstat(fd, &st) == 0 && (size_t)st.st_size < mapped_bytes) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                close(fd);
+                throw std::runtime_error("ShardTable: " + name + " was never initialized");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        void* base = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) throw std::runtime_error("ShardTable: cannot map " + name);
+        header = static_cast<Header*>(base);
+        chunks = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(base) + sizeof(Header));
+
+        if (creator) {
+            // ftruncate zero-fills: every slot and chunk starts free
+            header->magic = SEGMENT_MAGIC;
+            header->range_lo = lo;
+            header->range_hi = hi;
+            header->chunk_size = chunk_size;
+            header->chunk_count = count;
+            header->ready.store(1, std::memory_order_release);
+        }
+        while (header->ready.load(std::memory_order_acquire) != 1) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("ShardTable: " + name + " was never initialized");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header->magic != SEGMENT_MAGIC || header->range_lo != lo || header->range_hi != hi ||
+            header->chunk_size != chunk_size) {
+            throw std::runtime_error("ShardTable: " + name + " holds a different range");
+        }
+        #else
+        (void)name; (void)lo; (void)hi; (void)chunk_size;
+        throw std::runtime_error("ShardTable: sharding needs POSIX shared memory");
+        #endif
+    }
+
+    // Free slot, or one whose process stopped beating
+    void take_slot() {
+        int64_t now = now_ms();
+        for (size_t i = 0; i < MAX_PROCESSES; i++) {
+            ProcessSlot& s = header->slots[i];
+            uint64_t gen = s.generation.load(std::memory_order_acquire);
+            bool held = gen & 1;
+            if (held && now - s.heartbeat_ms.load(std::memory_order_acquire) <= stale_ms) continue;
+
+            // Beat before publishing the new generation so it never looks stale
+            s.heartbeat_ms.store(now, std::memory_order_release);
+            uint64_t next = held ? gen + 2 : gen + 1;
+            if (s.generation.compare_exchange_strong(gen, next, std::memory_order_acq_rel)) {
+                s.chunks_done.store(0, std::memory_order_relaxed);
+                slot = i;
+                claim_word = (next << 8) | (i + 1);
+                return;
+            }
+        }
+        throw std::runtime_error("ShardTable: all " + std::to_string(MAX_PROCESSES) + " process slots are live");
+    }
+
+public:
+    ShardTable(uint64_t lo, uint64_t hi, uint64_t chunk_size, std::chrono::milliseconds stale_after = std::chrono::seconds(10))
+        : stale_ms(stale_after.count()) {
+        if (hi < lo || chunk_size == 0) throw std::invalid_argument("ShardTable: empty range");
+        attach("/mersenne-shard-" + std::to_string(lo) + "-" + std::to_string(hi) + "-" + std::to_string(chunk_size) + "-v1",
+               lo, hi, chunk_size);
+        take_slot();
+
+        int64_t beat = std::max<int64_t>(stale_ms / 4, 1);
+        heartbeat_thread = std::thread([this, beat] {
+            while (running.load() && owns_slot()) {
+                header->slots[slot].heartbeat_ms.store(now_ms(), std::memory_order_release);
+                std::this_thread::sleep_for(std::chrono::milliseconds(beat));
+            }
+        });
+    }
+
+    ~ShardTable() {
+        running = false;
+        if (heartbeat_thread.joinable()) heartbeat_thread.join();
+        if (!header) return;
+
+        // Hand unfinished claims straight back, then release the slot
+        for (uint64_t c = 0; c < header->chunk_count; c++) {
+            uint64_t expected = claim_word;
+            chunks[c].compare_exchange_strong(expected, FREE, std::memory_order_acq_rel);
+        }
+        uint64_t gen = claim_word >> 8;
+        header->slots[slot].generation.compare_exchange_strong(gen, gen + 1, std::memory_order_acq_rel);
+        #if MERSENNE_SHARED_SEGMENTS
+        munmap(header, mapped_bytes);
+        #endif
+    }
+
+    ShardTable(const ShardTable&) = delete;
+    ShardTable& operator=(const ShardTable&) = delete;
+
+    uint64_t chunk_count() const { return header->chunk_count; }
+    size_t process_slot() const { return slot; }
+
+    // False once this process was presumed dead and its slot re-taken
+    bool owns_slot() const {
+        return header->slots[slot].generation.load(std::memory_order_acquire) == (claim_word >> 8);
+    }
+    // [first, last] exponents of a chunk
+    std::pair<uint64_t, uint64_t> chunk_range(uint64_t chunk) const {
+        uint64_t first = header->range_lo + chunk * header->chunk_size;
+        return {first, std::min(header->range_hi, first + header->chunk_size - 1)};
+    }
+
+    // Next free or orphaned chunk, now owned by this process. While the only
+    // unfinished chunks belong to live processes it waits, so a chunk whose
+    // owner dies at the tail is still picked up; false once all are done.
+    bool claim(uint64_t& chunk) {
+        while (owns_slot()) {
+            int64_t now = now_ms();
+            bool unfinished = false;
+            for (uint64_t c = 0; c < header->chunk_count; c++) {
+                uint64_t word = chunks[c].load(std::memory_order_acquire);
+                if (word == DONE) continue;
+                unfinished = true;
+                if (word != FREE && !orphaned(word, now)) continue;
+                if (chunks[c].compare_exchange_strong(word, claim_word, std::memory_order_acq_rel)) {
+                    chunk = c;
+                    return true;
+                }
+            }
+            if (!unfinished) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max<int64_t>(stale_ms / 4, 1)));
+        }
+        return false;
+    }
+
+    // Marks a chunk done; false if it was reclaimed in the meantime
+    bool complete(uint64_t chunk) {
+        uint64_t expected = claim_word;
+        if (!chunks[chunk].compare_exchange_strong(expected, DONE, std::memory_order_acq_rel)) return false;
+        header->slots[slot].chunks_done.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // True once every chunk is done
+    bool finished() const {
+        for (uint64_t c = 0; c < header->chunk_count; c++) {
+            if (chunks[c].load(std::memory_order_acquire) != DONE) return false;
+        }
+        return true;
+    }
+
+    Summary summary() const {
+        Summary s;
+        int64_t now = now_ms();
+        s.chunks = header->chunk_count;
+        for (uint64_t c = 0; c < header->chunk_count; c++) {
+            uint64_t word = chunks[c].load(std::memory_order_acquire);
+            if (word == DONE) s.done++;
+            else if (word == FREE || orphaned(word, now)) s.free++;
+            else s.claimed++;
+        }
+        for (const ProcessSlot& p : header->slots) {
+            if ((p.generation.load() & 1) && now - p.heartbeat_ms.load() <= stale_ms) s.live_processes++;
+        }
+        return s;
+    }
+};
@@ -0,0 +1,417 @@
+/*
+📚 SHARED READ-ONLY TABLES 📚
+One copy of every lookup table per process - and per node for the big ones.
+
+- Tiny primes (< 1024) and the mod-210 wheel: generated at compile time.
+- Small primes (< 1,000,000): sieved lazily, once per process.
+- FFT twiddles: built by the first process on the node into a named POSIX
+  shared-memory segment, then mapped read-only by every other worker process
+  instead of rebuilt per instance.
+
+Segments live in /dev/shm as mersenne-u<uid>-<table>-v2 with mode 0600 and
+are only trusted when owned by this user: a segment another user created
+under that name is ignored and the table is built privately. They are
+reference-counted by the pids attached to them: the last process to exit
+unlinks a segment, and segments left by crashed processes (no live user, or
+a builder that died before publishing) are unlinked by the next process
+that opens them or sweeps /dev/shm at startup, then rebuilt. A corrupt segment, or one whose
+builder is alive but too slow, falls back to a private copy.
+MERSENNE_SHARED_TABLES=0 keeps every table process-private.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MERSENNE_SHARED_SEGMENTS 1
+#ifdef __linux__
+#include <dirent.h>
+#endif
+#else
+#define MERSENNE_SHARED_SEGMENTS 0
+#endif
+
+// ========================================
+// COMPILE-TIME TABLES
+// ========================================
+
+namespace tables {
+
+constexpr bool is_prime_trial(uint32_t n) {
+    if (n < 2) return false;
+    for (uint32_t d = 2; d * d <= n; d++) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+constexpr size_t count_primes_below(uint32_t limit) {
+    size_t count = 0;
+    for (uint32_t n = 2; n < limit; n++) count += is_prime_trial(n);
+    return count;
+}
+
+template <uint32_t LIMIT>
+constexpr std::array<uint32_t, count_primes_below(LIMIT)> primes_below() {
+    std::array<uint32_t, count_primes_below(LIMIT)> primes{};
+    size_t i = 0;
+    for (uint32_t n = 2; n < LIMIT; n++) {
+        if (is_prime_trial(n)) primes[i++] = n;
+    }
+    return primes;
+}
+
+constexpr uint32_t TINY_PRIME_LIMIT = 1024;
+inline constexpr auto TINY_PRIMES = primes_below<TINY_PRIME_LIMIT>();
+
+// Residues mod 2*3*5*7 coprime to the modulus: every prime > 7 lands on one
+constexpr uint32_t WHEEL_MODULUS = 210;
+constexpr size_t WHEEL_SIZE = 48;
+
+constexpr std::array<uint16_t, WHEEL_SIZE> wheel_residues() {
+    std::array<uint16_t, WHEEL_SIZE> residues{};
+    size_t i = 0;
+    for (uint32_t r = 1; r < WHEEL_MODULUS; r++) {
+        if (r % 2 && r % 3 && r % 5 && r % 7) residues[i++] = (uint16_t)r;
+    }
+    return residues;
+}
+
+inline constexpr auto WHEEL_RESIDUES = wheel_residues();
+
+// Index of the first wheel residue >= r (WHEEL_SIZE = wrap to next turn)
+constexpr size_t wheel_index_at_or_after(uint32_t r) {
+    size_t i = 0;
+    while (i < WHEEL_SIZE && WHEEL_RESIDUES[i] < r) i++;
+    return i;
+}
+
+static_assert(TINY_PRIMES.size() == 172, "primes below 1024");
+static_assert(WHEEL_RESIDUES[WHEEL_SIZE - 1] == 209, "mod-210 wheel");
+
+} // namespace tables
+
+// ========================================
+// RUNTIME REGISTRY
+// ========================================
+
+class TableRegistry {
+private:
+    static constexpr uint64_t SEGMENT_MAGIC = 0x4d45525354424c32ULL;  // "MERSTBL2"
+    static constexpr size_t MAX_USERS = 128;
+    static constexpr int STALE_SECONDS = 10;    // A segment still unsized / unclaimed after this is abandoned
+    static constexpr int BUILD_WAIT_SECONDS = 120;
+    static constexpr double PI = 3.14159265358979323846;
+
+    // First page of a segment; table data starts on the next page so it can be
+    // made read-only while users still register here
+    struct SegmentHeader {
+        uint64_t magic;
+        uint64_t data_bytes;
+        std::atomic<uint32_t> ready;
+        std::atomic<int32_t> builder_pid;        // Written before the fill starts
+        std::atomic<int32_t> users[MAX_USERS];   // Attached pids, 0 = free slot
+    };
+
+    static_assert(sizeof(SegmentHeader) <= 4096, "segment header must fit its page");
+
+    struct Attachment {
+        std::string name;
+        SegmentHeader* header;
+    };
+
+    std::mutex registry_mutex;
+    std::map<std::string, const void*> tables_by_key;
+    std::vector<std::unique_ptr<char[]>> private_tables;
+    std::vector<Attachment> attachments;   // Segments this process is registered in
+    bool use_segments = MERSENNE_SHARED_SEGMENTS;
+
+    TableRegistry() {
+        const char* env = std::getenv("MERSENNE_SHARED_TABLES");
+        if (env && std::string(env) == "0") use_segments = false;
+        #if MERSENNE_SHARED_SEGMENTS
+        if (use_segments) {
+            sweep_abandoned_segments();
+            std::atexit([] { TableRegistry::instance().detach_all(); });
+        }
+        #endif
+    }
+
+    // Table data for `key`: from an existing node-wide segment, built into a
+    // new one, or (segments unavailable) built privately. Never unmapped.
+    const void* get_or_build(const std::string& key, size_t bytes, const std::function<void(void*)>& fill) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto it = tables_by_key.find(key);
+        if (it != tables_by_key.end()) return it->second;
+
+        const void* data = use_segments ? map_segment(key, bytes, fill) : nullptr;
+        if (!data) {
+            private_tables.push_back(std::unique_ptr<char[]>(new char[bytes]));
+            fill(private_tables.back().get());
+            data = private_tables.back().get();
+        }
+        tables_by_key[key] = data;
+        return data;
+    }
+
+    #if MERSENNE_SHARED_SEGMENTS
+    static size_t header_bytes() {
+        static const size_t bytes = std::max<size_t>(4096, (size_t)sysconf(_SC_PAGESIZE));
+        return bytes;
+    }
+
+    static bool process_alive(int32_t pid) {
+        return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    static bool has_live_users(const SegmentHeader* header) {
+        for (const auto& slot : header->users) {
+            if (process_alive(slot.load())) return true;
+        }
+        return false;
+    }
+
+    // Claims a free slot, else one left by an exited process
+    static bool add_user(SegmentHeader* header) {
+        int32_t self = (int32_t)getpid();
+        for (auto& slot : header->users) {
+            int32_t expected = 0;
+            if (slot.compare_exchange_strong(expected, self)) return true;
+        }
+        for (auto& slot : header->users) {
+            int32_t expected = slot.load();
+            if (!process_alive(expected) && slot.compare_exchange_strong(expected, self)) return true;
+        }
+        return false;   // Full of live users: attach unregistered
+    }
+
+    static int64_t seconds_since_change(const struct stat& st) {
+        return (int64_t)std::time(nullptr) - (int64_t)st.st_ctime;
+    }
+
+    // Nobody will ever publish or use it: the builder died mid-fill (or before
+    // even sizing the segment), or it is published and every user has exited
+    static bool abandoned(const SegmentHeader* header, const struct stat& st) {
+        if (header->ready.load(std::memory_order_acquire) == 1) return !has_live_users(header);
+        int32_t builder = header->builder_pid.load();
+        return builder ? !process_alive(builder) : seconds_since_change(st) > STALE_SECONDS;
+    }
+
+    // Unlinks `name` only while it still names the segment open on fd, so a
+    // replacement someone else already built survives
+    static void unlink_if_same(const std::string& name, int fd) {
+        int current = shm_open(name.c_str(), O_RDONLY, 0);
+        if (current < 0) return;
+        struct stat mine, theirs;
+        bool same = fstat(fd, &mine) == 0 && fstat(current, &theirs) == 0 &&
+                    mine.st_ino == theirs.st_ino && mine.st_dev == theirs.st_dev;
+        close(current);
+        if (same) shm_unlink(name.c_str());
+    }
+
+    void detach_all() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        int32_t self = (int32_t)getpid();
+        for (const Attachment& a : attachments) {
+            for (auto& slot : a.header->users) {
+                int32_t expected = self;
+                slot.compare_exchange_strong(expected, 0);
+            }
+            // Mappings stay valid after unlink, so late readers here are safe
+            if (!has_live_users(a.header)) shm_unlink(a.name.c_str());
+        }
+        attachments.clear();
+    }
+
+    void sweep_abandoned_segments() {
+        #ifdef __linux__
+        DIR* dir = opendir("/dev/shm");
+        if (!dir) return;
+        while (dirent* entry = readdir(dir)) {
+            std::string file = entry->d_name;
+            if (file.rfind("mersenne-", 0) != 0) continue;
+            std::string name = "/" + file;
+            if (file.size() > 3 && file.compare(file.size() - 3, 3, "-v1") == 0) {
+                shm_unlink(name.c_str());   // Pre-refcount layout: nothing maps these any more
+                continue;
+            }
+            if (file.size() < 3 || file.compare(file.size() - 3, 3, "-v2") != 0) continue;
+
+            int fd = shm_open(name.c_str(), O_RDONLY, 0);
+            if (fd < 0) continue;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_uid == geteuid()) {
+                if ((size_t)st.st_size < header_bytes()) {
+                    if (seconds_since_change(st) > STALE_SECONDS) unlink_if_same(name, fd);
+                } else {
+                    void* base = mmap(nullptr, header_bytes(), PROT_READ, MAP_SHARED, fd, 0);
+                    if (base != MAP_FAILED) {
+                        if (abandoned(static_cast<const SegmentHeader*>(base), st)) unlink_if_same(name, fd);
+                        munmap(base, header_bytes());
+                    }
+                }
+            }
+            close(fd);
+        }
+        closedir(dir);
+        #endif
+    }
+
+    const void* build_segment(const std::string& name, int fd, size_t bytes, const std::function<void(void*)>& fill) {
+        size_t total = header_bytes() + bytes;
+        if (ftruncate(fd, (off_t)total) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        SegmentHeader* header = static_cast<SegmentHeader*>(base);
+        header->builder_pid.store((int32_t)getpid());
+        header->magic = SEGMENT_MAGIC;
+        header->data_bytes = bytes;
+        add_user(header);
+        attachments.push_back({name, header});
+
+        char* data = static_cast<char*>(base) + header_bytes();
+        fill(data);
+        header->ready.store(1, std::memory_order_release);
+        mprotect(data, bytes, PROT_READ);  // Read-only from here on, builder included
+        return data;
+    }
+
+    // Maps a segment another process of this user builds. Returns nullptr with
+    // `stale` set when the segment is abandoned and should be replaced.
+    const void* attach_segment(const std::string& name, int fd, size_t bytes, bool& stale) {
+        size_t total = header_bytes() + bytes;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(BUILD_WAIT_SECONDS);
+
+        // Anyone can create a file under a predictable /dev/shm name: only
+        // our own segments are trusted to hold the real table
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_uid != geteuid()) return nullptr;
+        while (fstat(fd, &st) == 0 && (size_t)st.st_size < total) {
+            if (st.st_size == 0 && seconds_since_change(st) > STALE_SECONDS) { stale = true; return nullptr; }
+            if (std::chrono::steady_clock::now() > deadline) return nullptr;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if ((size_t)st.st_size != total) { stale = true; return nullptr; }
+
+        void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) return nullptr;
+
+        SegmentHeader* header = static_cast<SegmentHeader*>(base);
+        while (header->ready.load(std::memory_order_acquire) != 1) {
+            if (fstat(fd, &st) != 0 || abandoned(header, st)) { stale = true; munmap(base, total); return nullptr; }
+            if (std::chrono::steady_clock::now() > deadline) { munmap(base, total); return nullptr; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header->magic != SEGMENT_MAGIC || header->data_bytes != bytes) {
+            stale = true;
+            munmap(base, total);
+            return nullptr;
+        }
+
+        char* data = static_cast<char*>(base) + header_bytes();
+        if (add_user(header)) attachments.push_back({name, header});
+        mprotect(data, bytes, PROT_READ);
+        return data;
+    }
+    #endif
+
+    const void* map_segment(const std::string& key, size_t bytes, const std::function<void(void*)>& fill) {
+        #if MERSENNE_SHARED_SEGMENTS
+        std::string name = "/mersenne-u" + std::to_string(geteuid()) + "-" + key + "-v2";
+
+        for (int attempt = 0; attempt < 3; attempt++) {
+            // First process on the node builds the table...
+            int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd >= 0) return build_segment(name, fd, bytes, fill);
+
+            // ...everyone else maps it once the builder has published it and
+            // registers as a user (another user's segment: EACCES, private copy)
+            fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd < 0) {
+                if (errno == ENOENT) continue;   // Unlinked in between: try to build it
+                return nullptr;
+            }
+
+            bool stale = false;
+            const void* data = attach_segment(name, fd, bytes, stale);
+            if (!data && stale) unlink_if_same(name, fd);
+            close(fd);
+            if (data || !stale) return data;
+        }
+        return nullptr;
+        #else
+        (void)key; (void)bytes; (void)fill;
+        return nullptr;
+        #endif
+    }
+
+public:
+    // Intentionally leaked: table pointers are handed to threads that may
+    // outlive static destruction
+    static TableRegistry& instance() {
+        static TableRegistry* registry = new TableRegistry();
+        return *registry;
+    }
+
+    bool shared_segments_enabled() const { return use_segments; }
+
+    // All primes below 1,000,000 (78,498 of them), sieved once per process
+    const std::vector<uint32_t>& small_primes() {
+        static const std::vector<uint32_t> primes = []() {
+            const uint32_t LIMIT = 1000000;
+            std::vector<uint8_t> composite(LIMIT, 0);
+            std::vector<uint32_t> found;
+            found.reserve(78498);
+            for (uint32_t i = 2; i < LIMIT; i++) {
+                if (composite[i]) continue;
+                found.push_back(i);
+                for (uint64_t j = (uint64_t)i * i; j < LIMIT; j += i) composite[j] = 1;
+            }
+            return found;
+        }();
+        return primes;
+    }
+
+    // exp(-2*pi*i*k/n) for k < n
+    const std::complex<double>* twiddles(size_t n) {
+        const void* data = get_or_build("twiddle-" + std::to_string(n), n * sizeof(std::complex<double>),
+            [n](void* out) {
+                std::complex<double>* table = static_cast<std::complex<double>*>(out);
+                for (size_t k = 0; k < n; k++) {
+                    double angle = -2.0 * PI * k / n;
+                    table[k] = {std::cos(angle), std::sin(angle)};
+                }
+            });
+        return static_cast<const std::complex<double>*>(data);
+    }
+};
@@ -0,0 +1,252 @@
+/*
+⏱️ TIMELINE FLIGHT RECORDER ⏱️
+Always-on per-thread ring buffers of span and instant events.
+Dump as Chrome/Perfetto trace JSON (chrome://tracing or ui.perfetto.dev)
+via GET /api/trace, on SIGUSR1, or at exit.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json_string.h"
+
+// ========================================
+// EVENT STORAGE
+// ========================================
+
+// One recorded event. `name` and `category` must be string literals (or otherwise
+// outlive the process) - only the pointer is stored so recording never allocates.
+struct TraceEvent {
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    const char* name;
+    const char* category;
+    uint64_t arg;
+    uint32_t tid;
+    char phase;             // 'X' = complete span, 'i' = instant
+};
+
+// Single-writer ring buffer owned by one thread at a time. Old events are
+// overwritten once the buffer wraps, so the recorder always holds the most
+// recent history of every thread.
+class TraceBuffer {
+public:
+    static constexpr size_t CAPACITY = 8192;  // ~384KB per thread
+
+    TraceEvent events[CAPACITY];
+    std::atomic<uint64_t> head{0};
+    uint32_t tid = 0;
+    std::string thread_name;   // Guarded by the recorder's registry_mutex
+
+    void record(const TraceEvent& event) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        events[h & (CAPACITY - 1)] = event;
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+// ========================================
+// GLOBAL RECORDER
+// ========================================
+
+class TraceRecorder {
+private:
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::vector<TraceBuffer*> free_buffers;
+    std::atomic<uint32_t> next_tid{1};
+    std::atomic<bool> enabled{true};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    // Returns the buffer to the pool when its thread exits, so short-lived
+    // threads (one per HTTP request) don't grow the registry without bound.
+    struct ThreadSlot {
+        TraceBuffer* buffer = nullptr;
+        ~ThreadSlot() {
+            if (buffer) TraceRecorder::instance().release_buffer(buffer);
+        }
+    };
+
+    TraceRecorder() {
+        const char* env = std::getenv("MERSENNE_TRACE");
+        if (env && std::string(env) == "0") enabled = false;
+    }
+
+    TraceBuffer* acquire_buffer() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        TraceBuffer* buffer;
+        if (!free_buffers.empty()) {
+            buffer = free_buffers.back();
+            free_buffers.pop_back();
+        } else {
+            buffers.push_back(std::make_unique<TraceBuffer>());
+            buffer = buffers.back().get();
+        }
+        buffer->tid = next_tid++;
+        buffer->thread_name.clear();
+        return buffer;
+    }
+
+    void release_buffer(TraceBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        free_buffers.push_back(buffer);
+    }
+
+    TraceBuffer* thread_buffer() {
+        thread_local ThreadSlot slot;
+        if (!slot.buffer) slot.buffer = acquire_buffer();
+        return slot.buffer;
+    }
+
+public:
+    // Intentionally leaked: detached threads may still record after static
+    // destructors have started at exit
+    static TraceRecorder& instance() {
+        static TraceRecorder* recorder = new TraceRecorder();
+        return *recorder;
+    }
+
+    bool is_enabled() const { return enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool on) { enabled = on; }
+
+    uint64_t now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // The name belongs to the thread's buffer registration: it labels that
+    // buffer's events until the buffer is handed to another thread, so names
+    // never outnumber buffers however many threads come and go
+    void set_thread_name(const std::string& name) {
+        TraceBuffer* buffer = thread_buffer();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        buffer->thread_name = name;
+    }
+
+    void record_span(const char* name, const char* category, uint64_t start_ns, uint64_t arg) {
+        if (!is_enabled()) return;
+        TraceBuffer* buffer = thread_buffer();
+        uint64_t end_ns = now_ns();
+        buffer->record({start_ns, end_ns - start_ns, name, category, arg, buffer->tid, 'X'});
+    }
+
+    void record_instant(const char* name, const char* category, uint64_t arg = 0) {
+        if (!is_enabled()) return;
+        TraceBuffer* buffer = thread_buffer();
+        buffer->record({now_ns(), 0, name, category, arg, buffer->tid, 'i'});
+    }
+
+    // Snapshot every buffer into Chrome trace JSON. Writers are never blocked;
+    // slots that may be overwritten while we copy are skipped.
+    std::string export_chrome_json() {
+        std::stringstream json;
+        json << std::fixed << std::setprecision(3);
+        json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+
+        std::lock_guard<std::mutex> lock(registry_mutex);
+
+        for (const auto& buffer : buffers) {
+            if (buffer->thread_name.empty()) continue;
+            if (!first) json << ",";
+            first = false;
+            json << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"args\":{\"name\":";
+            write_json_string(json, buffer->thread_name);
+            json << "}}";
+        }
+
+        for (const auto& buffer : buffers) {
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t margin = TraceBuffer::CAPACITY / 16;
+            uint64_t begin = head > TraceBuffer::CAPACITY - margin ? head - (TraceBuffer::CAPACITY - margin) : 0;
+
+            for (uint64_t i = begin; i < head; i++) {
+                TraceEvent e = buffer->events[i & (TraceBuffer::CAPACITY - 1)];
+                if (!e.name) continue;
+
+                if (!first) json << ",";
+                first = false;
+                json << "{\"name\":";
+                write_json_string(json, e.name);
+                json << ",\"cat\":";
+                write_json_string(json, e.category);
+                json << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << e.tid
+                     << ",\"ts\":" << e.start_ns / 1000.0;
+                if (e.phase == 'X') json << ",\"dur\":" << e.duration_ns / 1000.0;
+                else json << ",\"s\":\"t\"";
+                json << ",\"args\":{\"arg\":" << e.arg << "}}";
+            }
+        }
+
+        json << "]}";
+        return json.str();
+    }
+
+    bool dump_to_file(const std::string& path) {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+        file << export_chrome_json();
+        return true;
+    }
+
+    // SIGUSR1 only raises a flag; a watcher thread does the actual (non
+    // signal-safe) export so the handler never touches the heap.
+    void install_signal_dump(const std::string& path) {
+        #ifndef _WIN32
+        std::signal(SIGUSR1, [](int) { dump_requested().store(true); });
+        std::thread([this, path]() {
+            while (true) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                if (dump_requested().exchange(false)) dump_to_file(path);
+            }
+        }).detach();
+        #else
+        (void)path;
+        #endif
+    }
+
+private:
+    static std::atomic<bool>& dump_requested() {
+        static std::atomic<bool> flag{false};
+        return flag;
+    }
+};
+
+// ========================================
+// SCOPED SPAN
+// ========================================
+
+// RAII span: records one complete event covering its lifetime.
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    uint64_t arg;
+    uint64_t start_ns;
+
+public:
+    TraceSpan(const char* span_name, const char* span_category, uint64_t span_arg = 0)
+        : name(span_name), category(span_category), arg(span_arg),
+          start_ns(TraceRecorder::instance().now_ns()) {}
+
+    ~TraceSpan() {
+        TraceRecorder::instance().record_span(name, category, start_ns, arg);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
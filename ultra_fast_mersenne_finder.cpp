@@ -22,264 +22,10 @@ This version is designed to be 10-100x faster than Python!
 #include <queue>
 #include <future>
 
-using namespace std;
-
-// ========================================
-// ASSEMBLY OPTIMIZATIONS & PRIME95 ALGORITHMS
-// ========================================
+#include "big_int.h"
+#include "yield_planner.h"
 
-#ifdef __x86_64__ || __amd64__
-// x86-64 assembly optimizations
-#define FAST_MUL64(a, b) ({ \
-    uint64_t result; \
-    __asm__("mulq %2" : "=a"(result) : "a"(a), "r"(b)); \
-    result; \
-})
-
-#define FAST_MOD64(a, m) ({ \
-    uint64_t result; \
-    __asm__("divq %2" : "=d"(result) : "a"(a), "r"(m)); \
-    result; \
-})
-#else
-// Fallback for other architectures
-#define FAST_MUL64(a, b) ((a) * (b))
-#define FAST_MOD64(a, m) ((a) % (m))
-#endif
-
-// ========================================
-// ENHANCED BIG INTEGER WITH ASSEMBLY OPTIMIZATIONS
-// ========================================
-
-struct UltraBigInt {
-    vector<uint64_t> d; // base 2^64 for maximum speed
-    
-    UltraBigInt(uint64_t val = 0) {
-        if (val) d.push_back(val);
-    }
-    
-    UltraBigInt(const string& s) {
-        from_string(s);
-    }
-    
-    void from_string(const string& s) {
-        d.clear();
-        UltraBigInt base(1);
-        UltraBigInt result(0);
-        
-        for (int i = s.length() - 1; i >= 0; i--) {
-            if (s[i] >= '0' && s[i] <= '9') {
-                result = result + base * UltraBigInt(s[i] - '0');
-                base = base * UltraBigInt(10);
-            }
-        }
-        *this = result;
-    }
-    
-    void trim() {
-        while (!d.empty() && d.back() == 0) d.pop_back();
-    }
-    
-    // Ultra-fast modular multiplication using Prime95 algorithms
-    static UltraBigInt fast_modmul(const UltraBigInt& a, const UltraBigInt& b, const UltraBigInt& mod) {
-        if (a.d.size() <= 2 && b.d.size() <= 2 && mod.d.size() <= 2) {
-            // Use assembly for small numbers
-            if (a.d.size() == 1 && b.d.size() == 1 && mod.d.size() == 1) {
-                uint64_t result = FAST_MOD64(FAST_MUL64(a.d[0], b.d[0]), mod.d[0]);
-                return UltraBigInt(result);
-            }
-        }
-        
-        // Fallback to optimized algorithm
-        UltraBigInt res;
-        res.d.assign(a.d.size() + b.d.size(), 0);
-        
-        for (size_t i = 0; i < a.d.size(); i++) {
-            uint64_t carry = 0;
-            for (size_t j = 0; j < b.d.size() || carry; j++) {
-                uint64_t cur = res.d[i + j] + 
-                               FAST_MUL64(a.d[i], (j < b.d.size() ? b.d[j] : 0)) + 
-                               carry;
-                res.d[i + j] = cur;
-                carry = cur >> 64;
-            }
-        }
-        
-        return res % mod;
-    }
-    
-    // Fast modular exponentiation (Prime95 style)
-    static UltraBigInt fast_pow_mod(const UltraBigInt& base, const UltraBigInt& exp, const UltraBigInt& mod) {
-        UltraBigInt result(1);
-        UltraBigInt b = base % mod;
-        UltraBigInt e = exp;
-        
-        while (!e.d.empty() && e.d[0] > 0) {
-            if (e.d[0] & 1) {
-                result = fast_modmul(result, b, mod);
-            }
-            b = fast_modmul(b, b, mod);
-            e >>= 1;
-        }
-        
-        return result;
-    }
-    
-    // Fast left shift
-    void operator<<=(int shift) {
-        if (!shift) return;
-        int word_shift = shift / 64;
-        int bit_shift = shift % 64;
-        
-        if (bit_shift == 0) {
-            d.insert(d.begin(), word_shift, 0);
-        } else {
-            uint64_t carry = 0;
-            for (size_t i = 0; i < d.size(); i++) {
-                uint64_t cur = (d[i] << bit_shift) | carry;
-                d[i] = cur;
-                carry = cur >> 64;
-            }
-            if (carry) d.push_back(carry);
-            d.insert(d.begin(), word_shift, 0);
-        }
-    }
-    
-    // Fast right shift
-    void operator>>=(int shift) {
-        if (!shift) return;
-        int word_shift = shift / 64;
-        int bit_shift = shift % 64;
-        
-        if (word_shift >= (int)d.size()) {
-            d.clear();
-            return;
-        }
-        
-        d.erase(d.begin(), d.begin() + word_shift);
-        
-        if (bit_shift > 0 && !d.empty()) {
-            uint64_t carry = 0;
-            for (int i = (int)d.size() - 1; i >= 0; i--) {
-                uint64_t cur = d[i];
-                d[i] = (cur >> bit_shift) | carry;
-                carry = cur << (64 - bit_shift);
-            }
-            trim();
-        }
-    }
-    
-    // Fast modulo operation
-    UltraBigInt operator%(const UltraBigInt& m) const {
-        if (cmp(*this, m) < 0) return *this;
-        
-        UltraBigInt res = *this;
-        UltraBigInt cur;
-        cur.d.assign(d.size(), 0);
-        
-        for (int i = (int)d.size() * 64 - 1; i >= 0; i--) {
-            cur <<= 1;
-            if (i < (int)d.size() * 64) {
-                int word_idx = i / 64;
-                int bit_idx = i % 64;
-                if (word_idx < (int)d.size()) {
-                    cur.d[0] |= (d[word_idx] >> bit_idx) & 1ULL;
-                }
-            }
-            if (cmp(cur, m) >= 0) {
-                cur = cur - m;
-            }
-        }
-        
-        return cur;
-    }
-    
-    // Fast subtraction
-    UltraBigInt operator-(const UltraBigInt& other) const {
-        UltraBigInt res = *this;
-        uint64_t carry = 0;
-        
-        for (size_t i = 0; i < other.d.size() || carry; i++) {
-            uint64_t cur = res.d[i] - (i < other.d.size() ? other.d[i] : 0) - carry;
-            carry = (cur >> 63);
-            res.d[i] = cur;
-        }
-        
-        res.trim();
-        return res;
-    }
-    
-    // Fast addition
-    UltraBigInt operator+(const UltraBigInt& other) const {
-        UltraBigInt res;
-        res.d.assign(max(d.size(), other.d.size()), 0);
-        
-        uint64_t carry = 0;
-        for (size_t i = 0; i < res.d.size() || carry; i++) {
-            uint64_t cur = carry;
-            if (i < d.size()) cur += d[i];
-            if (i < other.d.size()) cur += other.d[i];
-            res.d[i] = cur;
-            carry = cur >> 64;
-        }
-        
-        res.trim();
-        return res;
-    }
-    
-    // Fast multiplication
-    UltraBigInt operator*(const UltraBigInt& other) const {
-        UltraBigInt res;
-        res.d.assign(d.size() + other.d.size(), 0);
-        
-        for (size_t i = 0; i < d.size(); i++) {
-            uint64_t carry = 0;
-            for (size_t j = 0; j < other.d.size() || carry; j++) {
-                uint64_t cur = res.d[i + j] + 
-                               FAST_MUL64(d[i], (j < other.d.size() ? other.d[j] : 0)) + 
-                               carry;
-                res.d[i + j] = cur;
-                carry = cur >> 64;
-            }
-        }
-        
-        res.trim();
-        return res;
-    }
-    
-    // Comparison
-    static int cmp(const UltraBigInt& a, const UltraBigInt& b) {
-        if (a.d.size() != b.d.size()) 
-            return a.d.size() < b.d.size() ? -1 : 1;
-        
-        for (int i = (int)a.d.size() - 1; i >= 0; i--) {
-            if (a.d[i] != b.d[i]) 
-                return a.d[i] < b.d[i] ? -1 : 1;
-        }
-        return 0;
-    }
-    
-    // String conversion for output
-    string to_string() const {
-        if (d.empty()) return "0";
-        
-        string result;
-        UltraBigInt temp = *this;
-        
-        while (!temp.d.empty() && temp.d[0] > 0) {
-            uint64_t remainder = 0;
-            for (int i = (int)temp.d.size() - 1; i >= 0; i--) {
-                uint64_t cur = temp.d[i] + (remainder << 64);
-                temp.d[i] = cur / 10;
-                remainder = cur % 10;
-            }
-            result = char('0' + remainder) + result;
-            temp.trim();
-        }
-        
-        return result.empty() ? "0" : result;
-    }
-};
+using namespace std;
 
 // ========================================
 // ULTRA-FAST LUCAS-LEHMER TEST (PRIME95 STYLE)
@@ -297,22 +43,13 @@ bool ultra_fast_lucas_lehmer_test(int p) {
     }
     
     // Create M = 2^p - 1
-    UltraBigInt M;
-    M.d.assign((p + 63) / 64, 0);
-    M.d[p / 64] = 1ULL << (p % 64);
-    M = M - UltraBigInt(1);
+    BigInt M = BigInt::mersenne(p);
     
-    // Lucas-Lehmer test with Prime95 optimizations
-    UltraBigInt s(4);
+    // Lucas-Lehmer test: squaring tier picked by size, reduction by folding
+    BigInt s(4);
     
     for (int i = 0; i < p - 2; i++) {
-        // s = (s * s - 2) % M
-        s = UltraBigInt::fast_modmul(s, s, M);
-        s = s - UltraBigInt(2);
-        
-        // Early termination optimizations
-        if (s.d.empty()) return true;
-        if (cmp(s, M) >= 0) s = s - M;
+        s = (s * s - 2) % M;
         
         // Progress indicator for large exponents
         if (i % 100000 == 0 && i > 0) {
@@ -323,7 +60,7 @@ bool ultra_fast_lucas_lehmer_test(int p) {
     
     cout << "\r" << string(50, ' ') << "\r"; // Clear progress line
     
-    return s.d.empty();
+    return s.is_zero();
 }
 
 // ========================================
@@ -499,15 +236,12 @@ private:
     vector<int> discovered_primes;
     
 public:
-    void search_range(int start, int end, int thread_id) {
-        cout << "🔍 Thread " << thread_id << " searching range: " << start << " - " << end << endl;
+    // Work through the ranked queue, best expected yield per CPU-second first
+    void search_ranked(const vector<RankedExponent>& queue, atomic<size_t>& next, int thread_id) {
+        cout << "🔍 Thread " << thread_id << " pulling from the expected-yield queue" << endl;
         
-        for (int p = start; p <= end; p++) {
-            if (p % 2 == 0) continue; // Skip even numbers
-            
-            // Quick primality check
-            if (!ultra_fast_is_prime(p)) continue;
-            
+        for (size_t index = next++; index < queue.size(); index = next++) {
+            int p = (int)queue[index].p;
             candidates_tested++;
             
             // Lucas-Lehmer test
@@ -532,6 +266,48 @@ public:
         }
     }
     
+    // Prime exponents of the predicted ranges, ranked by expected discoveries
+    // per CPU-second. LL cost is one fused BigInt step, timed once per
+    // power-of-two limb count; TF / P-1 status from worktodo.txt or
+    // exponent_status.txt.
+    vector<RankedExponent> plan_candidates(const vector<pair<int, int>>& ranges) {
+        ExpectedYieldPlanner planner(
+            [](uint64_t p) {
+                size_t limbs = (p + 63) / 64, cls = 1;
+                while (cls < limbs) cls <<= 1;
+                return cls;
+            },
+            [](size_t, uint64_t p) {
+                BigInt M = BigInt::mersenne((int)p);
+                BigInt s = M - 12345;
+                auto start = chrono::steady_clock::now();
+                int reps = 0;
+                double elapsed = 0;
+                do {
+                    s = (s * s - 2) % M;
+                    reps++;
+                    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                } while (elapsed < 0.05);
+                return elapsed / reps;
+            });
+        size_t known = planner.load_status("worktodo.txt") + planner.load_status("exponent_status.txt");
+        
+        set<uint64_t> candidates;
+        for (const auto& range : ranges) {
+            for (int p = range.first | 1; p <= range.second; p += 2) {
+                if (ultra_fast_is_prime(p)) candidates.insert(p);
+            }
+        }
+        
+        vector<RankedExponent> ranked = planner.rank(vector<uint64_t>(candidates.begin(), candidates.end()));
+        cout << "🎯 Expected-yield plan: " << ranked.size() << " exponents, " << known << " with known TF/P-1 status" << endl;
+        for (size_t i = 0; i < ranked.size() && i < 5; i++) {
+            cout << "   p=" << ranked[i].p << "  P(prime)=" << scientific << setprecision(3) << ranked[i].prime_probability
+                 << "  LL " << fixed << setprecision(0) << ranked[i].ll_seconds << " s" << endl;
+        }
+        return ranked;
+    }
+    
     void save_result(int exponent) {
         ofstream file("discovered_mersenne_primes.txt", ios::app);
         if (file.is_open()) {
@@ -552,21 +328,15 @@ public:
         cout << "🚀 ULTRA-FAST MERSENNE PRIME SEARCH STARTING 🚀" << endl;
         cout << "=" << string(60, '=') << endl;
         
-        // Get predicted search ranges
+        // Predicted ranges bound the candidates; the planner orders them
         auto search_ranges = patterns.predict_search_ranges(num_predictions);
+        vector<RankedExponent> queue = plan_candidates(search_ranges);
         
-        // Create thread pool
+        // Create thread pool over the shared ranked queue
         vector<thread> threads;
-        int range_per_thread = max(1, (int)search_ranges.size() / num_threads);
-        
-        for (int i = 0; i < num_threads && i < (int)search_ranges.size(); i++) {
-            int start_idx = i * range_per_thread;
-            int end_idx = (i == num_threads - 1) ? search_ranges.size() : (i + 1) * range_per_thread;
-            
-            for (int j = start_idx; j < end_idx; j++) {
-                threads.emplace_back(&UltraFastMersenneFinder::search_range, this, 
-                                   search_ranges[j].first, search_ranges[j].second, i);
-            }
+        atomic<size_t> next{0};
+        for (int i = 0; i < num_threads; i++) {
+            threads.emplace_back(&UltraFastMersenneFinder::search_ranked, this, cref(queue), ref(next), i);
         }
         
         // Wait for all threads to complete
@@ -26,7 +26,14 @@ No GPU dependencies - pure CPU power!
 #include <condition_variable>
 #include <queue>
 #include <future>
-#include <immintrin.h>  // AVX2/AVX-512 instructions
+
+#include "cpu_dispatch.h"  // AVX2/AVX-512 kernels selected at runtime
+#include "shared_tables.h"
+#include "out_of_core_ll.h"
+#include "sampling_profiler.h"
+#include "fft_plan.h"
+#include "yield_planner.h"
+#include "shard_table.h"
 
 using namespace std;
 
@@ -37,7 +44,7 @@ using namespace std;
 #define MAX_PRECISION 1024  // Maximum bits of precision
 #define FFT_SIZE 8192       // FFT size for optimal performance
 #define CACHE_LINE 64       // CPU cache line size
-#define THREAD_CACHE_SIZE 1024  // Per-thread cache size
+#define THREAD_CACHE_SIZE 1024  // Per-thread cache size (FFT blocking is tuned per host - see fft_plan.h)
 
 // Precision levels for different exponent ranges
 enum PrecisionLevel {
@@ -56,102 +63,29 @@ enum PrecisionLevel {
 class FFTModularArithmetic {
 private:
     vector<complex<double>> fft_buffer;
-    vector<complex<double>> fft_twiddle;
+    const complex<double>* fft_twiddle;  // Shared read-only table (shared_tables.h)
     vector<complex<double>> fft_scratch;
     int fft_size;
-    bool avx512_available;
-    bool avx2_available;
+    FFTPlan fft_plan;
     
 public:
     FFTModularArithmetic(int size = FFT_SIZE) : fft_size(size) {
         fft_buffer.resize(size);
-        fft_twiddle.resize(size);
         fft_scratch.resize(size);
         
-        // Detect CPU capabilities
-        avx512_available = __builtin_cpu_supports("avx512f");
-        avx2_available = __builtin_cpu_supports("avx2");
+        // Mapped from the node-wide table, built only by the first process
+        fft_twiddle = TableRegistry::instance().twiddles(size);
         
-        // Initialize FFT twiddle factors
-        initialize_twiddle_factors();
+        // Host-tuned plan from fft_wisdom.txt (heuristic if this CPU was never tuned)
+        fft_plan = FFTPlanner::instance().plan_for(size);
         
+        const CpuFeatures& cpu = CpuFeatures::host();
         cout << "🔍 CPU Capabilities:" << endl;
-        cout << "   AVX-512: " << (avx512_available ? "✅ Available" : "❌ Not Available") << endl;
-        cout << "   AVX2: " << (avx2_available ? "✅ Available" : "❌ Not Available") << endl;
-    }
-    
-    void initialize_twiddle_factors() {
-        // Use SIMD if available for faster initialization
-        if (avx512_available) {
-            initialize_twiddle_avx512();
-        } else if (avx2_available) {
-            initialize_twiddle_avx2();
-        } else {
-            initialize_twiddle_standard();
-        }
-    }
-    
-    void initialize_twiddle_avx512() {
-        for (int i = 0; i < fft_size; i += 8) {
-            if (i + 7 < fft_size) {
-                __m512d angles = _mm512_set_pd(
-                    -2.0 * M_PI * (i + 7) / fft_size,
-                    -2.0 * M_PI * (i + 6) / fft_size,
-                    -2.0 * M_PI * (i + 5) / fft_size,
-                    -2.0 * M_PI * (i + 4) / fft_size,
-                    -2.0 * M_PI * (i + 3) / fft_size,
-                    -2.0 * M_PI * (i + 2) / fft_size,
-                    -2.0 * M_PI * (i + 1) / fft_size,
-                    -2.0 * M_PI * i / fft_size
-                );
-                
-                __m512d cos_vals = _mm512_cos_pd(angles);
-                __m512d sin_vals = _mm512_sin_pd(angles);
-                
-                for (int j = 0; j < 8; j++) {
-                    fft_twiddle[i + j] = complex<double>(cos_vals[j], sin_vals[j]);
-                }
-            } else {
-                // Handle remaining elements
-                for (int j = i; j < fft_size; j++) {
-                    double angle = -2.0 * M_PI * j / fft_size;
-                    fft_twiddle[j] = complex<double>(cos(angle), sin(angle));
-                }
-            }
-        }
-    }
-    
-    void initialize_twiddle_avx2() {
-        for (int i = 0; i < fft_size; i += 4) {
-            if (i + 3 < fft_size) {
-                __m256d angles = _mm256_set_pd(
-                    -2.0 * M_PI * (i + 3) / fft_size,
-                    -2.0 * M_PI * (i + 2) / fft_size,
-                    -2.0 * M_PI * (i + 1) / fft_size,
-                    -2.0 * M_PI * i / fft_size
-                );
-                
-                __m256d cos_vals = _mm256_cos_pd(angles);
-                __m256d sin_vals = _mm256_sin_pd(angles);
-                
-                for (int j = 0; j < 4; j++) {
-                    fft_twiddle[i + j] = complex<double>(cos_vals[j], sin_vals[j]);
-                }
-            } else {
-                // Handle remaining elements
-                for (int j = i; j < fft_size; j++) {
-                    double angle = -2.0 * M_PI * j / fft_size;
-                    fft_twiddle[j] = complex<double>(cos(angle), sin(angle));
-                }
-            }
-        }
-    }
-    
-    void initialize_twiddle_standard() {
-        for (int i = 0; i < fft_size; i++) {
-            double angle = -2.0 * M_PI * i / fft_size;
-            fft_twiddle[i] = complex<double>(cos(angle), sin(angle));
-        }
+        cout << "   AVX-512: " << (cpu.avx512 ? "✅ Available" : "❌ Not Available") << endl;
+        cout << "   AVX2: " << (cpu.avx2 ? "✅ Available" : "❌ Not Available") << endl;
+        cout << "   Kernel set: " << kernels().isa_name << endl;
+        cout << "   FFT plan: " << fft_plan.describe()
+             << (fft_plan.ns_per_transform > 0 ? " (tuned)" : " (default - run fft_tuner)") << endl;
     }
     
     // Ultra-fast FFT-based modular multiplication
@@ -185,78 +119,11 @@ public:
         return result;
     }
     
-    // CPU-optimized FFT modular multiplication
+    // CPU-optimized modular multiplication: a single 64x64->128 product and reduction.
+    // Vector work belongs in batched kernels (cpu_dispatch.h); one lane of a
+    // 512-bit register bought nothing here and required AVX-512 at build time.
     uint64_t cpu_modmul_fft(uint64_t a, uint64_t b, uint64_t mod) {
-        // Use AVX-512 if available
-        if (avx512_available) {
-            return avx512_modmul(a, b, mod);
-        } else if (avx2_available) {
-            return avx2_modmul(a, b, mod);
-        }
-        
-        // Fallback to standard algorithm
-        return standard_modmul(a, b, mod);
-    }
-    
-    // AVX-512 optimized modular multiplication
-    uint64_t avx512_modmul(uint64_t a, uint64_t b, uint64_t mod) {
-        // Use AVX-512 for maximum performance
-        __m512i a_vec = _mm512_set1_epi64(a);
-        __m512i b_vec = _mm512_set1_epi64(b);
-        __m512i mod_vec = _mm512_set1_epi64(mod);
-        
-        // Perform multiplication
-        __m512i result = _mm512_mullo_epi64(a_vec, b_vec);
-        
-        // Apply modulo using AVX-512
-        __m512i quotient = _mm512_div_epi64(result, mod_vec);
-        __m512i product = _mm512_mullo_epi64(quotient, mod_vec);
-        __m512i remainder = _mm512_sub_epi64(result, product);
-        
-        // Extract result
-        uint64_t results[8];
-        _mm512_store_si512(results, remainder);
-        
-        return results[0];
-    }
-    
-    // AVX2 optimized modular multiplication
-    uint64_t avx2_modmul(uint64_t a, uint64_t b, uint64_t mod) {
-        // Use AVX2 for good performance
-        __m256i a_vec = _mm256_set1_epi64x(a);
-        __m256i b_vec = _mm256_set1_epi64x(b);
-        __m256i mod_vec = _mm256_set1_epi64x(mod);
-        
-        // Perform multiplication
-        __m256i result = _mm256_mullo_epi64(a_vec, b_vec);
-        
-        // Apply modulo
-        __m256i quotient = _mm256_div_epi64(result, mod_vec);
-        __m256i product = _mm256_mullo_epi64(quotient, mod_vec);
-        __m256i remainder = _mm256_sub_epi64(result, product);
-        
-        // Extract result
-        uint64_t results[4];
-        _mm256_store_si256((__m256i*)results, remainder);
-        
-        return results[0];
-    }
-    
-    // Standard modular multiplication (fallback)
-    uint64_t standard_modmul(uint64_t a, uint64_t b, uint64_t mod) {
-        uint64_t result = 0;
-        a %= mod;
-        b %= mod;
-        
-        while (b > 0) {
-            if (b & 1) {
-                result = (result + a) % mod;
-            }
-            a = (a << 1) % mod;
-            b >>= 1;
-        }
-        
-        return result;
+        return (uint64_t)((unsigned __int128)a * b % mod);
     }
     
     // Fast FFT-based squaring
@@ -283,7 +150,7 @@ public:
         // Convert back to integers
         vector<uint64_t> result;
         for (int i = 0; i < fft_size; i++) {
-            uint64_t val = (uint64_t)round(a_fft[i].real() / fft_size);
+            uint64_t val = (uint64_t)round(a_fft[i].real());
             if (val > 0) {
                 result.push_back(val);
             }
@@ -292,153 +159,19 @@ public:
         return result;
     }
     
-    // FFT forward transform with SIMD optimization
+    // FFT forward transform: planned (radix, blocking, four-step, threads) per host
     void fft_forward(vector<complex<double>>& data) {
-        int n = data.size();
-        if (n <= 1) return;
-        
-        // Radix-2 FFT implementation
-        vector<complex<double>> even(n/2), odd(n/2);
-        for (int i = 0; i < n/2; i++) {
-            even[i] = data[2*i];
-            odd[i] = data[2*i+1];
-        }
-        
-        fft_forward(even);
-        fft_forward(odd);
-        
-        // Use SIMD for complex arithmetic if available
-        if (avx512_available) {
-            fft_combine_avx512(data, even, odd, n);
-        } else if (avx2_available) {
-            fft_combine_avx2(data, even, odd, n);
-        } else {
-            fft_combine_standard(data, even, odd, n);
-        }
-    }
-    
-    void fft_combine_avx512(vector<complex<double>>& data, const vector<complex<double>>& even, 
-                           const vector<complex<double>>& odd, int n) {
-        for (int k = 0; k < n/2; k += 8) {
-            if (k + 7 < n/2) {
-                // Load 8 twiddle factors
-                __m512d twiddle_real = _mm512_set_pd(
-                    fft_twiddle[k+7].real(), fft_twiddle[k+6].real(),
-                    fft_twiddle[k+5].real(), fft_twiddle[k+4].real(),
-                    fft_twiddle[k+3].real(), fft_twiddle[k+2].real(),
-                    fft_twiddle[k+1].real(), fft_twiddle[k].real()
-                );
-                __m512d twiddle_imag = _mm512_set_pd(
-                    fft_twiddle[k+7].imag(), fft_twiddle[k+6].imag(),
-                    fft_twiddle[k+5].imag(), fft_twiddle[k+4].imag(),
-                    fft_twiddle[k+3].imag(), fft_twiddle[k+2].imag(),
-                    fft_twiddle[k+1].imag(), fft_twiddle[k].imag()
-                );
-                
-                // Load 8 odd values
-                __m512d odd_real = _mm512_set_pd(
-                    odd[k+7].real(), odd[k+6].real(), odd[k+5].real(), odd[k+4].real(),
-                    odd[k+3].real(), odd[k+2].real(), odd[k+1].real(), odd[k].real()
-                );
-                __m512d odd_imag = _mm512_set_pd(
-                    odd[k+7].imag(), odd[k+6].imag(), odd[k+5].imag(), odd[k+4].imag(),
-                    odd[k+3].imag(), odd[k+2].imag(), odd[k+1].imag(), odd[k].imag()
-                );
-                
-                // Complex multiplication: (a+bi) * (c+di) = (ac-bd) + (ad+bc)i
-                __m512d temp_real = _mm512_fmsub_pd(twiddle_real, odd_real, _mm512_mul_pd(twiddle_imag, odd_imag));
-                __m512d temp_imag = _mm512_fmadd_pd(twiddle_real, odd_imag, _mm512_mul_pd(twiddle_imag, odd_real));
-                
-                // Store results
-                for (int i = 0; i < 8; i++) {
-                    complex<double> t(temp_real[i], temp_imag[i]);
-                    data[k] = even[k] + t;
-                    data[k + n/2] = even[k] - t;
-                    k++;
-                }
-                k -= 8; // Reset for next iteration
-            } else {
-                // Handle remaining elements
-                for (int i = k; i < n/2; i++) {
-                    complex<double> t = fft_twiddle[i] * odd[i];
-                    data[i] = even[i] + t;
-                    data[i + n/2] = even[i] - t;
-                }
-                break;
-            }
-        }
-    }
-    
-    void fft_combine_avx2(vector<complex<double>>& data, const vector<complex<double>>& even, 
-                          const vector<complex<double>>& odd, int n) {
-        for (int k = 0; k < n/2; k += 4) {
-            if (k + 3 < n/2) {
-                // Load 4 twiddle factors
-                __m256d twiddle_real = _mm256_set_pd(
-                    fft_twiddle[k+3].real(), fft_twiddle[k+2].real(),
-                    fft_twiddle[k+1].real(), fft_twiddle[k].real()
-                );
-                __m256d twiddle_imag = _mm256_set_pd(
-                    fft_twiddle[k+3].imag(), fft_twiddle[k+2].imag(),
-                    fft_twiddle[k+1].imag(), fft_twiddle[k].imag()
-                );
-                
-                // Load 4 odd values
-                __m256d odd_real = _mm256_set_pd(
-                    odd[k+3].real(), odd[k+2].real(), odd[k+1].real(), odd[k].real()
-                );
-                __m256d odd_imag = _mm256_set_pd(
-                    odd[k+3].imag(), odd[k+2].imag(), odd[k+1].imag(), odd[k].imag()
-                );
-                
-                // Complex multiplication
-                __m256d temp_real = _mm256_fmsub_pd(twiddle_real, odd_real, _mm256_mul_pd(twiddle_imag, odd_imag));
-                __m256d temp_imag = _mm256_fmadd_pd(twiddle_real, odd_imag, _mm256_mul_pd(twiddle_imag, odd_real));
-                
-                // Store results
-                for (int i = 0; i < 4; i++) {
-                    complex<double> t(temp_real[i], temp_imag[i]);
-                    data[k] = even[k] + t;
-                    data[k + n/2] = even[k] - t;
-                    k++;
-                }
-                k -= 4; // Reset for next iteration
-            } else {
-                // Handle remaining elements
-                for (int i = k; i < n/2; i++) {
-                    complex<double> t = fft_twiddle[i] * odd[i];
-                    data[i] = even[i] + t;
-                    data[i + n/2] = even[i] - t;
-                }
-                break;
-            }
-        }
+        FFTPlanner::instance().execute(fft_plan_for(data.size()), data, false);
     }
     
-    void fft_combine_standard(vector<complex<double>>& data, const vector<complex<double>>& even, 
-                             const vector<complex<double>>& odd, int n) {
-        for (int k = 0; k < n/2; k++) {
-            complex<double> t = fft_twiddle[k] * odd[k];
-            data[k] = even[k] + t;
-            data[k + n/2] = even[k] - t;
-        }
+    // FFT inverse transform (normalized by 1/n)
+    void fft_inverse(vector<complex<double>>& data) {
+        FFTPlanner::instance().execute(fft_plan_for(data.size()), data, true);
     }
     
-    // FFT inverse transform
-    void fft_inverse(vector<complex<double>>& data) {
-        // Conjugate the input
-        for (auto& val : data) {
-            val = conj(val);
-        }
-        
-        // Forward FFT
-        fft_forward(data);
-        
-        // Conjugate and scale
-        for (auto& val : data) {
-            val = conj(val);
-            val /= data.size();
-        }
+    FFTPlan fft_plan_for(size_t n) {
+        if (n == fft_plan.n) return fft_plan;
+        return FFTPlanner::instance().plan_for(n);
     }
 };
 
@@ -449,38 +182,13 @@ public:
 class UltraFastLucasLehmer {
 private:
     FFTModularArithmetic fft_math;
-    vector<uint64_t> small_primes;
+    const vector<uint32_t>& small_primes = TableRegistry::instance().small_primes();  // Sieved once per process
     PrecisionLevel precision_level;
+    OutOfCoreLucasLehmer out_of_core{OutOfCoreLucasLehmer::load_memory_limit_bytes()};  // memory_limit_gb
     
 public:
-    UltraFastLucasLehmer() {
-        // Initialize small primes for early factor checking
-        initialize_small_primes();
-    }
-    
-    void initialize_small_primes() {
-        // Segmented sieve for better memory efficiency
-        const int SEGMENT_SIZE = 1000000;
-        vector<bool> is_prime(SEGMENT_SIZE, true);
-        is_prime[0] = is_prime[1] = false;
-        
-        for (int i = 2; i * i < SEGMENT_SIZE; i++) {
-            if (is_prime[i]) {
-                for (int j = i * i; j < SEGMENT_SIZE; j += i) {
-                    is_prime[j] = false;
-                }
-            }
-        }
-        
-        for (int i = 2; i < SEGMENT_SIZE; i++) {
-            if (is_prime[i]) {
-                small_primes.push_back(i);
-            }
-        }
-    }
-    
     // Determine precision level based on exponent
-    PrecisionLevel get_precision_level(int exponent) {
+    PrecisionLevel get_precision_level(uint64_t exponent) {
         if (exponent < 10000000) return PRECISION_32;
         if (exponent < 100000000) return PRECISION_64;
         if (exponent < 1000000000) return PRECISION_128;
@@ -490,7 +198,7 @@ public:
     }
     
     // Ultra-fast Lucas-Lehmer test with multiple optimizations
-    bool ultra_fast_lucas_lehmer_test(int p) {
+    bool ultra_fast_lucas_lehmer_test(uint64_t p) {
         if (p == 2) return true;
         
         // Set precision level
@@ -501,6 +209,16 @@ public:
             return false;
         }
         
+        // Trial factoring: cheap proof of compositeness for most exponents
+        if (trial_factor(p) != 0) {
+            return false;
+        }
+        
+        // Residue larger than the node's memory budget: stream it from disk
+        if (out_of_core.needed_for(p)) {
+            return out_of_core.run(p).is_prime;
+        }
+        
         // Create M = 2^p - 1 with optimal precision
         vector<uint64_t> M = create_mersenne_number(p);
         
@@ -509,7 +227,7 @@ public:
     }
     
     // Early factor check using small primes
-    bool early_factor_check(int p) {
+    bool early_factor_check(uint64_t p) {
         for (uint64_t prime : small_primes) {
             if (prime >= p) break;
             if (p % prime == 0) {
@@ -519,14 +237,51 @@ public:
         return true;
     }
     
+    // Smallest factor q = 2kp + 1 of 2^p - 1 below 2^TF_BITS, or 0 if none.
+    // Factors are also ±1 mod 8; survivors are batched through the ISA-dispatched modexp.
+    // The k range is capped too, so small exponents don't scan 2^44 / 2p candidates.
+    static const int TF_BITS = 44;
+    static const uint64_t TF_MAX_K = 1 << 20;
+    static const size_t TF_BATCH = 256;
+    
+    uint64_t trial_factor(uint64_t p) {
+        // A proper factor is at most sqrt(M_p), so small exponents stop early
+        int bits = (int)min<uint64_t>(TF_BITS, (p + 1) / 2);
+        uint64_t limit = min(1ULL << bits, 2ULL * p * TF_MAX_K + 1);
+        
+        const KernelTable& k = kernels();
+        uint64_t candidates[TF_BATCH], residues[TF_BATCH];
+        size_t count = 0;
+        auto flush = [&]() -> uint64_t {
+            k.tf_modexp_batch(p, candidates, residues, count);
+            for (size_t i = 0; i < count; i++) {
+                if (residues[i] == 1) return candidates[i];
+            }
+            count = 0;
+            return 0;
+        };
+        
+        for (uint64_t q = 2ULL * p + 1; q <= limit; q += 2ULL * p) {
+            uint64_t r8 = q & 7;
+            if (r8 != 1 && r8 != 7) continue;
+            if (q > 13 && (q % 3 == 0 || q % 5 == 0 || q % 7 == 0 || q % 11 == 0 || q % 13 == 0)) continue;
+            
+            candidates[count++] = q;
+            if (count == TF_BATCH) {
+                if (uint64_t factor = flush()) return factor;
+            }
+        }
+        return count > 0 ? flush() : 0;
+    }
+    
     // Create Mersenne number 2^p - 1 with optimal precision
-    vector<uint64_t> create_mersenne_number(int p) {
+    vector<uint64_t> create_mersenne_number(uint64_t p) {
         vector<uint64_t> M;
-        int words_needed = (p + 63) / 64;
+        size_t words_needed = (p + 63) / 64;
         M.resize(words_needed, 0);
         
         // Set the appropriate bit
-        int word_index = p / 64;
+        size_t word_index = p / 64;
         int bit_index = p % 64;
         M[word_index] = 1ULL << bit_index;
         
@@ -548,12 +303,12 @@ public:
     }
     
     // FFT-accelerated Lucas-Lehmer test
-    bool lucas_lehmer_fft(int p, const vector<uint64_t>& M) {
+    bool lucas_lehmer_fft(uint64_t p, const vector<uint64_t>& M) {
         // Initialize s = 4
         vector<uint64_t> s = {4};
         
         // Main Lucas-Lehmer loop with optimizations
-        for (int i = 0; i < p - 2; i++) {
+        for (uint64_t i = 0; i < p - 2; i++) {
             // s = (s * s - 2) % M using FFT
             s = fft_square_mod(s, M);
             s = fft_subtract_2(s, M);
@@ -660,32 +415,38 @@ public:
 
 class UltraFastPrimalityTest {
 private:
-    vector<uint64_t> small_primes;
+    const vector<uint32_t>& small_primes = TableRegistry::instance().small_primes();  // Sieved once per process
     
-public:
-    UltraFastPrimalityTest() {
-        // Initialize small primes using segmented sieve
-        initialize_small_primes();
-    }
+    static const size_t SEGMENT_LENGTH = 32768;
     
-    void initialize_small_primes() {
-        // Segmented sieve for better memory efficiency
-        const int SEGMENT_SIZE = 1000000;
-        vector<bool> is_prime(SEGMENT_SIZE, true);
-        
-        for (int i = 2; i * i < SEGMENT_SIZE; i++) {
-            if (is_prime[i]) {
-                for (int j = i * i; j < SEGMENT_SIZE; j += i) {
-                    is_prime[j] = false;
-                }
+public:
+    // All primes in [lo, hi]: segment sieve pre-filter, then batched
+    // deterministic Miller-Rabin, both from the host's ISA kernel set
+    vector<uint64_t> primes_in_range(uint64_t lo, uint64_t hi) {
+        const KernelTable& k = kernels();
+        vector<uint64_t> primes;
+        vector<uint8_t> composite(SEGMENT_LENGTH);
+        vector<uint64_t> survivors;
+        vector<uint8_t> verdicts;
+        
+        for (uint64_t seg = lo; seg <= hi; seg += SEGMENT_LENGTH) {
+            size_t len = (size_t)min<uint64_t>(SEGMENT_LENGTH, hi - seg + 1);
+            // Pre-filter with the compile-time tiny-prime table
+            k.sieve_segment(composite.data(), seg, len, tables::TINY_PRIMES.data(), tables::TINY_PRIMES.size());
+            
+            survivors.clear();
+            for (size_t i = 0; i < len; i++) {
+                uint64_t n = seg + i;
+                if (!composite[i] && n >= 2 && (n & 1 || n == 2)) survivors.push_back(n);
             }
-        }
-        
-        for (int i = 2; i < SEGMENT_SIZE; i++) {
-            if (is_prime[i]) {
-                small_primes.push_back(i);
+            
+            verdicts.resize(survivors.size());
+            k.mr_batch(survivors.data(), verdicts.data(), survivors.size());
+            for (size_t i = 0; i < survivors.size(); i++) {
+                if (verdicts[i]) primes.push_back(survivors[i]);
             }
         }
+        return primes;
     }
     
     // Ultra-fast primality test with multiple optimizations
@@ -820,7 +581,6 @@ public:
 
 class UltraSpeedMersenneFinder {
 private:
-    UltraFastLucasLehmer ll_test;
     UltraFastPrimalityTest primality_test;
     atomic<uint64_t> candidates_tested{0};
     atomic<uint64_t> candidates_found{0};
@@ -836,19 +596,17 @@ public:
         start_time = chrono::high_resolution_clock::now();
     }
     
-    // Search a specific range with maximum speed
-    void search_range_ultra_fast(uint64_t start, uint64_t end, int thread_id) {
-        cout << "🚀 Thread " << thread_id << " searching range: " << start << " - " << end << endl;
+    // Work through the ranked queue, best expected yield per CPU-second first
+    void search_ranked(const vector<RankedExponent>& queue, atomic<size_t>& next, int thread_id) {
+        cout << "🚀 Thread " << thread_id << " pulling from the expected-yield queue" << endl;
+        ProfiledThread profiled;
+        UltraFastLucasLehmer ll_test;   // One per thread: it keeps per-run state (out-of-core buffers, precision)
         
         uint64_t last_report = 0;
         auto last_time = chrono::high_resolution_clock::now();
         
-        for (uint64_t p = start; p <= end; p++) {
-            if (p % 2 == 0) continue; // Skip even numbers
-            
-            // Quick primality check
-            if (!primality_test.ultra_fast_is_prime(p)) continue;
-            
+        for (size_t index = next++; index < queue.size(); index = next++) {
+            uint64_t p = queue[index].p;
             candidates_tested++;
             
             // Ultra-fast Lucas-Lehmer test
@@ -885,6 +643,90 @@ public:
         }
     }
     
+    // Prime exponents of the candidate ranges, ranked by expected discoveries
+    // per CPU-second: TF / P-1 status from worktodo.txt or exponent_status.txt,
+    // LL cost measured once per FFT length
+    vector<RankedExponent> plan_candidates(const vector<pair<uint64_t, uint64_t>>& ranges) {
+        ExpectedYieldPlanner planner(
+            [](uint64_t p) { return OutOfCoreLucasLehmer::fft_length_for(p); },
+            [](size_t n, uint64_t) { return ExpectedYieldPlanner::time_fft_iteration(n); });
+        size_t known = planner.load_status("worktodo.txt") + planner.load_status("exponent_status.txt");
+        
+        vector<uint64_t> candidates;
+        for (const auto& range : ranges) {
+            vector<uint64_t> primes = primality_test.primes_in_range(range.first, range.second);
+            candidates.insert(candidates.end(), primes.begin(), primes.end());
+        }
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+        
+        vector<RankedExponent> ranked = planner.rank(candidates);
+        cout << "🎯 Expected-yield plan: " << ranked.size() << " exponents, " << known << " with known TF/P-1 status" << endl;
+        for (size_t i = 0; i < ranked.size() && i < 5; i++) {
+            cout << "   p=" << ranked[i].p << "  P(prime)=" << scientific << setprecision(3) << ranked[i].prime_probability
+                 << "  LL " << fixed << setprecision(0) << ranked[i].ll_seconds << " s" << endl;
+        }
+        return ranked;
+    }
+    
+    // Claim chunks from the node's shard table until none is left
+    void search_shard(ShardTable& table, int thread_id) {
+        ProfiledThread profiled;
+        UltraFastLucasLehmer ll_test;   // One per thread: it keeps per-run state (out-of-core buffers, precision)
+        uint64_t chunk;
+        while (table.claim(chunk)) {
+            pair<uint64_t, uint64_t> range = table.chunk_range(chunk);
+            for (uint64_t p : primality_test.primes_in_range(range.first, range.second)) {
+                candidates_tested++;
+                if (ll_test.ultra_fast_lucas_lehmer_test(p)) {
+                    lock_guard<mutex> lock(results_mutex);
+                    discovered_primes.push_back(p);
+                    candidates_found++;
+                    
+                    cout << "\n🎉 MERSENNE PRIME FOUND! p = " << p << endl;
+                    cout << "   Shard slot " << table.process_slot() << ", thread " << thread_id << endl;
+                    save_result(p);
+                }
+            }
+            if (!table.complete(chunk)) {
+                cout << "\n⚠️ Chunk " << chunk << " was reclaimed while this process was stalled" << endl;
+            }
+        }
+    }
+    
+    // Local sharding: every process started with the same range attaches to
+    // one shared-memory table and takes whichever chunks are free
+    void run_sharded_search(uint64_t lo, uint64_t hi, uint64_t chunk_size, int num_threads) {
+        ShardTable table(lo, hi, chunk_size);
+        cout << "🧩 Sharding " << lo << " - " << hi << " in " << table.chunk_count() << " chunks of "
+             << chunk_size << " (process slot " << table.process_slot() << ")" << endl;
+        
+        vector<thread> threads;
+        atomic<int> running{num_threads};
+        for (int i = 0; i < num_threads; i++) {
+            threads.emplace_back([this, &table, &running, i] {
+                search_shard(table, i);
+                running--;
+            });
+        }
+        
+        // Node-wide progress, as seen by every process in the table
+        auto last = chrono::steady_clock::now();
+        while (running > 0) {
+            this_thread::sleep_for(chrono::milliseconds(200));
+            if (chrono::steady_clock::now() - last < chrono::seconds(5)) continue;
+            last = chrono::steady_clock::now();
+            ShardTable::Summary s = table.summary();
+            cout << "\r   Shards: " << s.done << "/" << s.chunks << " done, " << s.claimed << " claimed, "
+                 << s.live_processes << " live processes, " << candidates_tested << " tested here" << flush;
+        }
+        for (auto& t : threads) t.join();
+        
+        ShardTable::Summary s = table.summary();
+        cout << "\n🎯 This process: " << candidates_tested << " tested, " << candidates_found << " found; table "
+             << s.done << "/" << s.chunks << " chunks done" << endl;
+    }
+    
     // Get elapsed time since start
     string get_elapsed_time() {
         auto current_time = chrono::high_resolution_clock::now();
@@ -924,21 +766,16 @@ public:
         cout << "CPU-Only Version - Optimized for Acer Aspire 5 (12th Gen Intel)" << endl;
         cout << "=" << string(70, '=') << endl;
         
-        // Calculate search ranges based on pattern analysis
+        // Candidate window for the planner
         vector<pair<uint64_t, uint64_t>> search_ranges = calculate_search_ranges(num_predictions);
         
-        // Create thread pool
-        vector<thread> threads;
-        int range_per_thread = max(1, (int)search_ranges.size() / num_threads);
+        vector<RankedExponent> queue = plan_candidates(search_ranges);
         
-        for (int i = 0; i < num_threads && i < (int)search_ranges.size(); i++) {
-            int start_idx = i * range_per_thread;
-            int end_idx = (i == num_threads - 1) ? search_ranges.size() : (i + 1) * range_per_thread;
-            
-            for (int j = start_idx; j < end_idx; j++) {
-                threads.emplace_back(&UltraSpeedMersenneFinder::search_range_ultra_fast, this, 
-                                   search_ranges[j].first, search_ranges[j].second, i);
-            }
+        // Create thread pool over the shared ranked queue
+        vector<thread> threads;
+        atomic<size_t> next{0};
+        for (int i = 0; i < num_threads; i++) {
+            threads.emplace_back(&UltraSpeedMersenneFinder::search_ranked, this, cref(queue), ref(next), i);
         }
         
         // Wait for all threads to complete
@@ -964,11 +801,11 @@ public:
         cout << "\nResults saved to: ultra_speed_mersenne_results.txt" << endl;
     }
     
-    // Calculate optimal search ranges
+    // Candidate window; the order inside it comes from the expected-yield planner
     vector<pair<uint64_t, uint64_t>> calculate_search_ranges(int num_predictions) {
         vector<pair<uint64_t, uint64_t>> ranges;
         
-        // Based on pattern analysis, next primes likely in these ranges
+        // Untested territory just above the current record
         uint64_t base_ranges[] = {85000000, 90000000, 95000000, 100000000, 105000000};
         
         for (int i = 0; i < num_predictions && i < 5; i++) {
@@ -987,10 +824,25 @@ public:
 // MAIN FUNCTION
 // ========================================
 
-int main() {
+int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
     
+    // ultra_speed_mersenne_finder_cpu_only --shard LO HI [CHUNK] [THREADS]
+    if (argc >= 4 && string(argv[1]) == "--shard") {
+        uint64_t lo = strtoull(argv[2], nullptr, 10), hi = strtoull(argv[3], nullptr, 10);
+        uint64_t chunk = argc >= 5 ? strtoull(argv[4], nullptr, 10) : 10000;
+        int threads = argc >= 6 ? atoi(argv[5]) : (int)max(1u, thread::hardware_concurrency());
+        try {
+            UltraSpeedMersenneFinder finder;
+            finder.run_sharded_search(lo, hi, chunk, threads);
+        } catch (const exception& e) {
+            cout << "\n❌ Error during sharded search: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
     cout << "🚀 ULTRA-SPEED MERSENNE PRIME FINDER (CPU-ONLY) 🚀" << endl;
     cout << "Maximum Speed + Precision for Acer Aspire 5" << endl;
     cout << "12th Gen Intel - Pure CPU Power!" << endl;
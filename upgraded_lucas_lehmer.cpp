@@ -9,12 +9,16 @@ Modern optimizations: FFT multiplication, Montgomery reduction, parallel process
 #include <atomic>
 #include <immintrin.h>
 
+#include "sampling_profiler.h"
+#include "big_int.h"
+#include "montgomery.h"
+#include "gcd.h"
+
 using namespace std;
 
 class UpgradedLucasLehmer {
 private:
     static constexpr int FFT_THRESHOLD = 1000;
-    static constexpr double PI = 3.14159265358979323846;
     
 public:
     // FFT-based multiplication for large numbers
@@ -44,62 +48,62 @@ public:
         return result;
     }
     
+    // Planned transform: per-host tuned variant from fft_wisdom.txt
     void fft(vector<complex<double>>& a, bool invert) {
-        int n = a.size();
-        for (int i = 1, j = 0; i < n; i++) {
-            int bit = n >> 1;
-            for (; j & bit; bit >>= 1) j ^= bit;
-            j ^= bit;
-            if (i < j) swap(a[i], a[j]);
-        }
-        
-        for (int len = 2; len <= n; len <<= 1) {
-            double ang = 2 * PI / len * (invert ? -1 : 1);
-            complex<double> wlen(cos(ang), sin(ang));
-            for (int i = 0; i < n; i += len) {
-                complex<double> w(1);
-                for (int j = 0; j < len / 2; j++) {
-                    complex<double> u = a[i + j], v = a[i + j + len / 2] * w;
-                    a[i + j] = u + v;
-                    a[i + j + len / 2] = u - v;
-                    w *= wlen;
-                }
-            }
-        }
-        
-        if (invert) {
-            for (complex<double>& x : a) x /= n;
-        }
+        FFTPlanner::instance().execute(a, invert);
     }
     
-    // Montgomery reduction for modular arithmetic
+    // Montgomery reduction for modular arithmetic (any odd modulus; see montgomery.h)
     class MontgomeryReduction {
     private:
-        vector<uint64_t> mod, r, r_inv, mod_inv;
-        int bits;
+        bigint::Montgomery context;
         
     public:
-        MontgomeryReduction(const vector<uint64_t>& modulus) : mod(modulus) {
-            bits = modulus.size() * 64;
-            r.resize(modulus.size() + 1, 0);
-            r.back() = 1; // r = 2^bits
-            
-            // Compute r^-1 mod modulus and modulus^-1 mod r
-            compute_inverses();
+        MontgomeryReduction(const vector<uint64_t>& modulus)
+            : context(BigInt::from_limbs(modulus.data(), modulus.size())) {}
+        
+        // Montgomery reduction: (x * r^-1) mod m for x < m * r, r = 2^(64 * limbs)
+        vector<uint64_t> reduce(const vector<uint64_t>& x) const {
+            size_t k = context.limbs();
+            vector<uint64_t> t(2 * k, 0), result(k);
+            copy_n(x.begin(), min(x.size(), 2 * k), t.begin());
+            context.reduce(result.data(), t.data());
+            return result;
         }
         
-        void compute_inverses() {
-            // Extended Euclidean algorithm for computing inverses
-            // Simplified implementation
+        BigInt multiply(const BigInt& a, const BigInt& b) const { return context.mul_mod(a, b); }
+        BigInt power(const BigInt& base, const BigInt& exponent) const { return context.pow_mod(base, exponent); }
+    };
+    
+    // q divides 2^p - 1 iff 2^p = 1 (mod q); q of any size
+    bool is_factor(const BigInt& q, int p) {
+        if (q <= BigInt(1) || !q.is_odd()) return false;
+        MontgomeryReduction mont(vector<uint64_t>(q.data(), q.data() + q.size()));
+        return mont.power(2, p) == BigInt(1);
+    }
+    
+    // P-1 stage 1: x = 3^(E * 2p) mod 2^p - 1 with E = prod of prime powers <= B1,
+    // then gcd(x - 1, 2^p - 1). Finds any factor q = 2kp + 1 with k B1-smooth.
+    BigInt p_minus_1_stage1(int p, uint64_t B1) {
+        BigInt M = BigInt::mersenne(p);
+        BigInt exponent = BigInt(2) * BigInt((uint64_t)p);
+        vector<bool> composite(B1 + 1, false);
+        for (uint64_t q = 2; q <= B1; q++) {
+            if (composite[q]) continue;
+            for (uint64_t j = q * q; j <= B1; j += q) composite[j] = true;
+            uint64_t power = q;
+            while (power <= B1 / q) power *= q;
+            exponent *= BigInt(power);
         }
         
-        vector<uint64_t> reduce(const vector<uint64_t>& x) {
-            // Montgomery reduction: (x * r^-1) mod m
-            vector<uint64_t> result = x;
-            // Simplified Montgomery reduction
-            return result;
+        BigInt x(1);
+        for (size_t i = exponent.bit_length(); i-- > 0;) {
+            x = (x * x) % M;
+            if (exponent.bit(i)) x = (x * BigInt(3)) % M;
         }
-    };
+        if (x.is_zero()) return M;
+        return bigint::gcd(x - 1, M);
+    }
     
     // Optimized Lucas-Lehmer test with multiple improvements
     bool upgraded_lucas_lehmer_test(int p) {
@@ -125,251 +129,39 @@ private:
         uint64_t M = (1ULL << p) - 1;
         
         for (int i = 0; i < p - 2; i++) {
-            s = ((s * s) - 2) % M;
+            s = (uint64_t)(((__uint128_t)s * s + M - 2) % M);
         }
         
         return s == 0;
     }
     
-    // Medium exponents: optimized big integer arithmetic
+    // Medium exponents: Karatsuba squaring in the shared big-integer core
     bool medium_lucas_lehmer(int p) {
-        vector<uint64_t> s = {4};
-        vector<uint64_t> M = compute_mersenne_number(p);
-        
-        for (int i = 0; i < p - 2; i++) {
-            s = square_and_subtract_2(s);
-            s = mod_reduce(s, M);
-            
-            if (i % 1000 == 0) {
-                double progress = (double)i / (p - 2) * 100.0;
-                cout << "\r📊 Progress: " << fixed << setprecision(1) 
-                     << progress << "% (" << i << "/" << (p-2) << ")" << flush;
-            }
-        }
-        
-        cout << "\r" << string(50, ' ') << "\r";
-        return is_zero(s);
+        return bigint_lucas_lehmer(p);
     }
     
-    // Large exponents: FFT-based multiplication
+    // Large exponents: the same core switches to FFT / NTT squaring by itself
     bool large_lucas_lehmer(int p) {
         cout << "🔬 Using FFT-based computation for large exponent" << endl;
-        
-        // For very large exponents, we need specialized big integer libraries
-        // This is a placeholder for the full implementation
-        return false; // Would need GMP or similar library
-    }
-    
-    vector<uint64_t> compute_mersenne_number(int p) {
-        // Compute 2^p - 1 efficiently
-        int words = (p + 63) / 64;
-        vector<uint64_t> result(words, 0);
-        
-        int full_words = p / 64;
-        int remaining_bits = p % 64;
-        
-        // Set all bits in full words
-        for (int i = 0; i < full_words; i++) {
-            result[i] = UINT64_MAX;
-        }
-        
-        // Set remaining bits in the last word
-        if (remaining_bits > 0) {
-            result[full_words] = (1ULL << remaining_bits) - 1;
-        }
-        
-        return result;
-    }
-    
-    vector<uint64_t> square_and_subtract_2(const vector<uint64_t>& x) {
-        // Optimized squaring with Karatsuba algorithm for medium sizes
-        if (x.size() == 1) {
-            uint64_t val = x[0];
-            __uint128_t square = (__uint128_t)val * val;
-            if (square >= 2) square -= 2;
-            
-            vector<uint64_t> result;
-            result.push_back(square & UINT64_MAX);
-            if (square >> 64) {
-                result.push_back(square >> 64);
-            }
-            return result;
-        }
-        
-        // For larger numbers, use Karatsuba multiplication
-        return karatsuba_square(x);
+        return bigint_lucas_lehmer(p);
     }
     
-    vector<uint64_t> karatsuba_square(const vector<uint64_t>& x) {
-        int n = x.size();
-        if (n <= 4) {
-            return schoolbook_square(x);
-        }
-        
-        int half = n / 2;
-        vector<uint64_t> low(x.begin(), x.begin() + half);
-        vector<uint64_t> high(x.begin() + half, x.end());
-        
-        auto z0 = karatsuba_square(low);
-        auto z2 = karatsuba_square(high);
-        
-        // (low + high)^2
-        auto sum = add_vectors(low, high);
-        auto z1 = karatsuba_square(sum);
-        
-        // z1 = z1 - z2 - z0
-        z1 = subtract_vectors(z1, z2);
-        z1 = subtract_vectors(z1, z0);
-        
-        // Combine: z2 * 2^(2*half*64) + z1 * 2^(half*64) + z0
-        vector<uint64_t> result(2 * n, 0);
-        
-        // Add z0
-        for (int i = 0; i < z0.size(); i++) {
-            result[i] += z0[i];
-        }
+    bool bigint_lucas_lehmer(int p) {
+        BigInt s(4);
+        BigInt M = BigInt::mersenne(p);
         
-        // Add z1 shifted by half
-        for (int i = 0; i < z1.size(); i++) {
-            if (i + half < result.size()) {
-                result[i + half] += z1[i];
-            }
-        }
-        
-        // Add z2 shifted by 2*half
-        for (int i = 0; i < z2.size(); i++) {
-            if (i + 2 * half < result.size()) {
-                result[i + 2 * half] += z2[i];
-            }
-        }
-        
-        // Handle carries
-        handle_carries(result);
-        
-        // Subtract 2
-        if (result[0] >= 2) {
-            result[0] -= 2;
-        } else {
-            // Borrow from higher words
-            int i = 0;
-            while (i < result.size() && result[i] == 0) {
-                result[i] = UINT64_MAX - 1;
-                i++;
-            }
-            if (i < result.size()) {
-                result[i]--;
-            }
-        }
-        
-        // Remove leading zeros
-        while (result.size() > 1 && result.back() == 0) {
-            result.pop_back();
-        }
-        
-        return result;
-    }
-    
-    vector<uint64_t> schoolbook_square(const vector<uint64_t>& x) {
-        int n = x.size();
-        vector<uint64_t> result(2 * n, 0);
-        
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                __uint128_t prod = (__uint128_t)x[i] * x[j];
-                result[i + j] += prod & UINT64_MAX;
-                result[i + j + 1] += prod >> 64;
-            }
-        }
-        
-        handle_carries(result);
-        return result;
-    }
-    
-    void handle_carries(vector<uint64_t>& x) {
-        for (int i = 0; i < x.size() - 1; i++) {
-            if (x[i] >= (1ULL << 32)) {
-                x[i + 1] += x[i] >> 32;
-                x[i] &= (1ULL << 32) - 1;
-            }
-        }
-    }
-    
-    vector<uint64_t> add_vectors(const vector<uint64_t>& a, const vector<uint64_t>& b) {
-        int max_size = max(a.size(), b.size());
-        vector<uint64_t> result(max_size + 1, 0);
-        
-        uint64_t carry = 0;
-        for (int i = 0; i < max_size; i++) {
-            uint64_t sum = carry;
-            if (i < a.size()) sum += a[i];
-            if (i < b.size()) sum += b[i];
-            
-            result[i] = sum;
-            carry = (sum < carry || (i < a.size() && sum < a[i]) || (i < b.size() && sum < b[i])) ? 1 : 0;
-        }
-        
-        if (carry) result[max_size] = 1;
-        else result.pop_back();
-        
-        return result;
-    }
-    
-    vector<uint64_t> subtract_vectors(const vector<uint64_t>& a, const vector<uint64_t>& b) {
-        vector<uint64_t> result = a;
-        uint64_t borrow = 0;
-        
-        for (int i = 0; i < b.size() || borrow; i++) {
-            uint64_t sub = borrow;
-            if (i < b.size()) sub += b[i];
+        for (int i = 0; i < p - 2; i++) {
+            s = (s * s - 2) % M;
             
-            if (result[i] >= sub) {
-                result[i] -= sub;
-                borrow = 0;
-            } else {
-                result[i] = result[i] + UINT64_MAX + 1 - sub;
-                borrow = 1;
-            }
-        }
-        
-        while (result.size() > 1 && result.back() == 0) {
-            result.pop_back();
-        }
-        
-        return result;
-    }
-    
-    vector<uint64_t> mod_reduce(const vector<uint64_t>& x, const vector<uint64_t>& mod) {
-        // Simplified modular reduction
-        // For full implementation, would use Barrett reduction or Montgomery reduction
-        if (compare_vectors(x, mod) < 0) return x;
-        
-        vector<uint64_t> result = x;
-        while (compare_vectors(result, mod) >= 0) {
-            result = subtract_vectors(result, mod);
-        }
-        
-        return result;
-    }
-    
-    int compare_vectors(const vector<uint64_t>& a, const vector<uint64_t>& b) {
-        if (a.size() != b.size()) {
-            return a.size() < b.size() ? -1 : 1;
-        }
-        
-        for (int i = a.size() - 1; i >= 0; i--) {
-            if (a[i] != b[i]) {
-                return a[i] < b[i] ? -1 : 1;
+            if (i % 1000 == 0) {
+                double progress = (double)i / (p - 2) * 100.0;
+                cout << "\r📊 Progress: " << fixed << setprecision(1) 
+                     << progress << "% (" << i << "/" << (p-2) << ")" << flush;
             }
         }
         
-        return 0;
-    }
-    
-    bool is_zero(const vector<uint64_t>& x) {
-        for (uint64_t val : x) {
-            if (val != 0) return false;
-        }
-        return true;
+        cout << "\r" << string(50, ' ') << "\r";
+        return s.is_zero();
     }
 };
 
@@ -389,6 +181,7 @@ public:
         
         for (int t = 0; t < num_threads; t++) {
             threads.emplace_back([&, t]() {
+                ProfiledThread profiled;
                 int idx;
                 while ((idx = candidate_index.fetch_add(1)) < candidates.size()) {
                     int p = candidates[idx];
@@ -421,6 +214,7 @@ public:
 };
 
 int main() {
+    ProfiledThread profiled_main;  // Active only with MERSENNE_PROFILE=1
     UpgradedLucasLehmer ll_test;
     
     // Test known Mersenne primes
@@ -432,6 +226,14 @@ int main() {
         cout << "p=" << p << ": " << (result ? "✅ PRIME" : "❌ COMPOSITE") << endl;
     }
     
+    // Factor verification: M67 = 193707721 * 761838257287
+    cout << "🔎 193707721 divides 2^67 - 1: " << (ll_test.is_factor(193707721, 67) ? "✅ yes" : "❌ no") << endl;
+    cout << "🔎 193707723 divides 2^67 - 1: " << (ll_test.is_factor(193707723, 67) ? "✅ yes" : "❌ no") << endl;
+    
+    // P-1 on M67: 193707721 - 1 = 2 * 67 * 2^2 * 3^3 * 5 * 2677
+    BigInt factor = ll_test.p_minus_1_stage1(67, 3000);
+    cout << "🔎 P-1 (B1=3000) on 2^67 - 1: " << factor << endl;
+    
     // Test parallel implementation
     ParallelLucasLehmer parallel_test;
     vector<int> candidates = {61, 89, 107, 127}; // Some candidates to test
@@ -0,0 +1,256 @@
+/*
+🎯 EXPECTED-YIELD EXPONENT PLANNER 🎯
+Orders candidate exponents by expected discoveries per CPU-second instead of
+guessing where the next prime "should" be.
+
+- Prime probability (Wagstaff heuristic): P(M_p prime | no factor below 2^b)
+  ~ e^gamma * b / p, with b at least log2(a*p) (a = 2 for p = 3 mod 4, 6 for
+  p = 1 mod 4)
+- A clean P-1 run raises it by 1 / (1 - chance P-1 would have found a factor),
+  the chance summed over factor bit levels with Dickman's rho for the B1 part
+  and the one-large-prime B2 part of k = (q - 1) / 2p
+- Cost: p iterations at the measured per-iteration time of the exponent's
+  cost class (FFT length, limb size class...), measured once per class
+- Work status comes from Prime95's worktodo.txt lines (Test=, DoubleCheck=,
+  PRP=, Pminus1=) or "p tf_bits [B1 B2]" lines; unknown exponents count as
+  never factored
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fft_plan.h"
+
+struct ExponentStatus {
+    double tf_bits = 0;   // Trial factored to 2^tf_bits (0 = not at all)
+    uint64_t b1 = 0;      // P-1 bounds (0 = no P-1 done)
+    uint64_t b2 = 0;
+};
+
+struct RankedExponent {
+    uint64_t p;
+    double prime_probability;
+    double ll_seconds;
+    double yield_per_second;   // Expected discoveries per CPU-second
+};
+
+class ExpectedYieldPlanner {
+public:
+    using CostClass = std::function<size_t(uint64_t exponent)>;
+    using IterationTimer = std::function<double(size_t cost_class, uint64_t exponent)>;
+
+private:
+    CostClass cost_class;
+    IterationTimer time_iteration;
+    std::map<uint64_t, ExponentStatus> status;
+
+    std::mutex cost_mutex;
+    std::map<size_t, double> seconds_per_iteration;   // Measured, per cost class
+
+    static constexpr double EULER_GAMMA = 0.5772156649015329;
+    static constexpr double RHO_STEP = 0.01;
+    static constexpr double RHO_MAX_U = 20.0;
+
+    // Dickman's rho on [0, RHO_MAX_U]: rho = 1 on [0, 1], u rho'(u) = -rho(u - 1)
+    static const std::vector<double>& rho_table() {
+        static const std::vector<double>* table = [] {
+            size_t steps = (size_t)(RHO_MAX_U / RHO_STEP) + 1;
+            size_t lag = (size_t)(1.0 / RHO_STEP);
+            auto* t = new std::vector<double>(steps, 1.0);
+            for (size_t i = lag + 1; i < steps; i++) {
+                // Trapezoid on rho' over [u - h, u]
+                double u0 = (i - 1) * RHO_STEP, u1 = i * RHO_STEP;
+                double d0 = (*t)[i - 1 - lag] / u0, d1 = (*t)[i - lag] / u1;
+                (*t)[i] = (*t)[i - 1] - 0.5 * RHO_STEP * (d0 + d1);
+            }
+            return t;
+        }();
+        return *table;
+    }
+
+    static double rho(double u) {
+        if (u <= 1) return 1.0;
+        if (u >= RHO_MAX_U) return 0.0;
+        const std::vector<double>& t = rho_table();
+        double x = u / RHO_STEP;
+        size_t i = (size_t)x;
+        return t[i] + (x - i) * (t[i + 1] - t[i]);
+    }
+
+    // Chance that k (of ln_k natural-log size) is B1-smooth, or B1-smooth
+    // times one prime in (B1, B2]
+    static double smooth_probability(double ln_k, uint64_t b1, uint64_t b2) {
+        if (ln_k <= 0) return 1.0;
+        double ln_b1 = std::log((double)b1);
+        double chance = rho(ln_k / ln_b1);
+        if (b2 > b1) {
+            // Integral over ln t in (ln B1, ln B2] of rho((ln k - ln t) / ln B1) / ln t
+            const int STEPS = 32;
+            double ln_b2 = std::log((double)b2), h = (ln_b2 - ln_b1) / STEPS;
+            for (int i = 0; i < STEPS; i++) {
+                double v = ln_b1 + (i + 0.5) * h;
+                if (v >= ln_k) break;
+                chance += rho((ln_k - v) / ln_b1) * h / v;
+            }
+        }
+        return std::min(chance, 1.0);
+    }
+
+public:
+    ExpectedYieldPlanner(CostClass classify, IterationTimer timer)
+        : cost_class(std::move(classify)), time_iteration(std::move(timer)) {}
+
+    // Per-iteration cost of the planned complex FFT at n points (forward +
+    // inverse), the bulk of one LL step for FFT-based engines
+    static double time_fft_iteration(size_t n) {
+        std::vector<std::complex<double>> data(n, std::complex<double>(1.0, 0.5));
+        FFTPlanner& planner = FFTPlanner::instance();
+        FFTPlan plan = planner.plan_for(n);
+        int reps = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        do {
+            planner.execute(plan, data.data(), n, false);
+            planner.execute(plan, data.data(), n, true);
+            reps++;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 0.05 && reps < 1000);
+        return elapsed / reps;
+    }
+
+    // ========================================
+    // WORK STATUS
+    // ========================================
+
+    void set_status(uint64_t p, const ExponentStatus& s) { status[p] = s; }
+
+    // Returns the number of exponents read; a missing file reads as none
+    size_t load_status(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        size_t loaded = 0;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+            size_t eq = line.find('=');
+            if (eq != std::string::npos) {
+                if (parse_worktodo(line.substr(0, eq), line.substr(eq + 1))) loaded++;
+                continue;
+            }
+            std::istringstream fields(line);
+            uint64_t p;
+            ExponentStatus s;
+            if (!(fields >> p >> s.tf_bits)) continue;
+            fields >> s.b1 >> s.b2;
+            status[p] = s;
+            loaded++;
+        }
+        return loaded;
+    }
+
+private:
+    // Test=[AID,]p,tf_bits,pm1_done  DoubleCheck= same  PRP=[AID,]k,b,n,c,tf_bits,tests_saved
+    // Pminus1=[AID,]k,b,n,c,B1,B2[,tf_bits]
+    bool parse_worktodo(const std::string& kind, const std::string& body) {
+        std::vector<std::string> fields;
+        std::stringstream in(body);
+        std::string field;
+        while (std::getline(in, field, ',')) fields.push_back(field);
+        if (!fields.empty() && fields[0].size() == 32 && fields[0].find_first_not_of("0123456789abcdefABCDEF") == std::string::npos) {
+            fields.erase(fields.begin());   // Assignment ID
+        }
+        if (fields.empty() || fields[0].find_first_not_of("0123456789") != std::string::npos) {
+            fields.erase(fields.begin(), fields.begin() + std::min<size_t>(1, fields.size()));
+        }
+
+        try {
+            if ((kind == "Test" || kind == "DoubleCheck") && fields.size() >= 2) {
+                ExponentStatus& s = status[std::stoull(fields[0])];
+                s.tf_bits = std::max(s.tf_bits, std::stod(fields[1]));
+                return true;
+            }
+            if ((kind == "PRP" || kind == "PRPDC") && fields.size() >= 5) {
+                ExponentStatus& s = status[std::stoull(fields[2])];
+                s.tf_bits = std::max(s.tf_bits, std::stod(fields[4]));
+                return true;
+            }
+            if (kind == "Pminus1" && fields.size() >= 6) {
+                ExponentStatus& s = status[std::stoull(fields[2])];
+                s.b1 = std::stoull(fields[4]);
+                s.b2 = std::stoull(fields[5]);
+                if (fields.size() >= 7) s.tf_bits = std::max(s.tf_bits, std::stod(fields[6]));
+                return true;
+            }
+        } catch (const std::exception&) {
+            // Malformed line: skip it like Prime95 would
+        }
+        return false;
+    }
+
+public:
+    // ========================================
+    // MODEL
+    // ========================================
+
+    static double prime_probability(uint64_t p, const ExponentStatus& s) {
+        double a = (p % 4 == 1) ? 6.0 : 2.0;
+        double bits = std::max(s.tf_bits, std::log2(a * (double)p));
+        double chance = std::exp(EULER_GAMMA) * bits / (double)p;
+
+        if (s.b1 > 1) {
+            // A factor has about a 1/x chance of being in bit level x (x > tf bits);
+            // P-1 finds it when k = q / 2p is smooth
+            double found = 0, ln_2p = std::log(2.0 * p);
+            double first = std::floor(std::max(s.tf_bits, std::log2(2.0 * p))) + 1;
+            for (double x = first; x < first + 256 && x <= p / 2.0; x++) {
+                double ln_k = x * std::log(2.0) - ln_2p;
+                double smooth = smooth_probability(ln_k, s.b1, s.b2);
+                if (smooth < 1e-9) break;
+                found += smooth / x;
+            }
+            chance /= std::max(1e-3, 1.0 - std::min(found, 0.999));
+        }
+        return std::min(chance, 1.0);
+    }
+
+    double ll_seconds(uint64_t p) {
+        size_t cls = cost_class(p);
+        double per_iteration;
+        {
+            std::lock_guard<std::mutex> lock(cost_mutex);
+            auto it = seconds_per_iteration.find(cls);
+            if (it == seconds_per_iteration.end()) {
+                it = seconds_per_iteration.emplace(cls, time_iteration(cls, p)).first;
+            }
+            per_iteration = it->second;
+        }
+        return per_iteration * (double)(p > 2 ? p - 2 : 1);
+    }
+
+    // Candidates in descending expected yield per CPU-second
+    std::vector<RankedExponent> rank(const std::vector<uint64_t>& exponents) {
+        std::vector<RankedExponent> ranked;
+        ranked.reserve(exponents.size());
+        for (uint64_t p : exponents) {
+            auto it = status.find(p);
+            double chance = prime_probability(p, it == status.end() ? ExponentStatus() : it->second);
+            double seconds = std::max(ll_seconds(p), 1e-12);
+            ranked.push_back({p, chance, seconds, chance / seconds});
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [](const RankedExponent& x, const RankedExponent& y) {
+            return x.yield_per_second > y.yield_per_second;
+        });
+        return ranked;
+    }
+};